@@ -5,12 +5,20 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QStandardPaths>
+#include "models/DiscoveryFilter.h"
 
 const char* Config::DEFAULT_USER = "user";
 
 Config::Config()
     : user(DEFAULT_USER)
     , extend(DEFAULT_EXTEND)
+    , directGitDirOpen(true)
+    , concurrency(0)
+    , maxDepth(0)
+    , exclude(DiscoveryOptions::defaultExclude())
+    , stopAtRepos(true)
+    , submodules(false)
+    , followSymlinks(true)
 {
 }
 
@@ -117,6 +125,66 @@ Result<VoidValue, QString> Config::load()
         }
     }
 
+    // Parse ceiling directories (optional)
+    ceilingDirs.clear();
+    if (obj.contains("ceilingDirs") && obj["ceilingDirs"].isArray()) {
+        for (const QJsonValue& val : obj["ceilingDirs"].toArray()) {
+            if (val.isString()) {
+                ceilingDirs.append(val.toString());
+            }
+        }
+    }
+
+    // Parse direct git dir open (optional, default true)
+    if (obj.contains("directGitDirOpen") && obj["directGitDirOpen"].isBool()) {
+        directGitDirOpen = obj["directGitDirOpen"].toBool();
+    } else {
+        directGitDirOpen = true;
+    }
+
+    // Parse bulk task concurrency (optional, default 0 = one per core)
+    if (obj.contains("concurrency") && obj["concurrency"].isDouble()) {
+        concurrency = qMax(0, obj["concurrency"].toInt());
+    } else {
+        concurrency = 0;
+    }
+
+    // Parse discovery options (optional)
+    if (obj.contains("maxDepth") && obj["maxDepth"].isDouble()) {
+        maxDepth = qMax(0, obj["maxDepth"].toInt());
+    } else {
+        maxDepth = 0;
+    }
+
+    if (obj.contains("exclude") && obj["exclude"].isArray()) {
+        exclude.clear();
+        for (const QJsonValue& val : obj["exclude"].toArray()) {
+            if (val.isString()) {
+                exclude.append(val.toString());
+            }
+        }
+    } else {
+        exclude = DiscoveryOptions::defaultExclude();
+    }
+
+    if (obj.contains("stopAtRepos") && obj["stopAtRepos"].isBool()) {
+        stopAtRepos = obj["stopAtRepos"].toBool();
+    } else {
+        stopAtRepos = true;
+    }
+
+    if (obj.contains("submodules") && obj["submodules"].isBool()) {
+        submodules = obj["submodules"].toBool();
+    } else {
+        submodules = false;
+    }
+
+    if (obj.contains("followSymlinks") && obj["followSymlinks"].isBool()) {
+        followSymlinks = obj["followSymlinks"].toBool();
+    } else {
+        followSymlinks = true;
+    }
+
     return OkVoid();
 }
 
@@ -162,6 +230,18 @@ Result<VoidValue, QString> Config::save() const
     }
     obj["ignore"] = ignoreArray;
 
+    // Write repository open options
+    obj["ceilingDirs"] = QJsonArray::fromStringList(ceilingDirs);
+    obj["directGitDirOpen"] = directGitDirOpen;
+    obj["concurrency"] = concurrency;
+
+    // Write discovery options
+    obj["maxDepth"] = maxDepth;
+    obj["exclude"] = QJsonArray::fromStringList(exclude);
+    obj["stopAtRepos"] = stopAtRepos;
+    obj["submodules"] = submodules;
+    obj["followSymlinks"] = followSymlinks;
+
     QJsonDocument doc(obj);
     QString path = getConfigPath();
     QFile file(path);
@@ -183,6 +263,16 @@ Result<VoidValue, QString> Config::createDefault()
     user = DEFAULT_USER;
     extend = DEFAULT_EXTEND;
     ignore.clear();
+    ceilingDirs.clear();
+    directGitDirOpen = true;
+    concurrency = 0;
+
+    DiscoveryOptions discovery;
+    maxDepth = discovery.maxDepth;
+    exclude = discovery.exclude;
+    stopAtRepos = discovery.stopAtRepos;
+    submodules = discovery.submodules;
+    followSymlinks = discovery.followSymlinks;
 
     return save();
 }
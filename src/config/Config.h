@@ -23,6 +23,14 @@ public:
     QString user;               // Username for branch naming validation
     int extend;                 // Pixels to add when window is extended
     QVariantList ignore;        // Patterns to filter from changes list
+    QStringList ceilingDirs;    // Upper bound for repository search on open
+    bool directGitDirOpen;      // Open repositories from their resolved git dir
+    int concurrency;            // Parallel repositories for bulk tasks (0 = auto)
+    int maxDepth;               // Directory levels searched below each root (0 = unlimited)
+    QStringList exclude;        // Directory globs skipped by discovery
+    bool stopAtRepos;           // Do not search for repositories inside repositories
+    bool submodules;            // Still discover submodules when stopping at a repository
+    bool followSymlinks;        // Follow symlinked directories during discovery
 
     // Get platform-specific config file path
     static QString getConfigPath();
@@ -5,11 +5,13 @@
 #include <QStyleFactory>
 #include <QPalette>
 #include <QDir>
+#include <QDebug>
 
 AppController::AppController(QObject *parent)
     : QObject(parent)
     , m_folderModel(nullptr)
     , m_gitWorker(nullptr)
+    , m_repoWatcher(nullptr)
     , m_mainScreen(nullptr)
     , m_mainWindow(nullptr)
     , m_autoUpdateTimer(nullptr)
@@ -42,21 +44,17 @@ bool AppController::initialize()
     // Create folder model and scan paths
     m_folderModel = new FolderTreeModel(this);
 
-    // Filter out non-existent paths
-    QStringList validPaths;
-    for (const QString& path : m_config.paths) {
-        if (QDir(path).exists()) {
-            validPaths.append(path);
-        } else {
-            QMessageBox::warning(nullptr, "Invalid Path",
-                QString("The following path does not exist and will be skipped:\n%1").arg(path));
-        }
-    }
-
-    m_folderModel->scanPaths(validPaths);
+    m_folderModel->setDiscoveryOptions(discoveryOptions());
+    m_folderModel->scanPaths(existingPaths(true));
 
     // Create git worker thread
     m_gitWorker = new GitWorker();
+    applyWorkerOptions();
+
+    // Watcher feeds the worker's status cache so unchanged repos are skipped
+    m_repoWatcher = new RepoWatcher(m_gitWorker->statusCache(), this);
+    connect(m_gitWorker, &GitWorker::snapshotStored, m_repoWatcher, &RepoWatcher::syncRepo);
+
     m_gitWorker->start();
 
     // Setup main window
@@ -113,6 +111,7 @@ void AppController::setupMainWindow()
     m_mainScreen = new MainScreen();
     m_mainScreen->setFolderModel(m_folderModel);
     m_mainScreen->setGitWorker(m_gitWorker);
+    connect(m_mainScreen, &MainScreen::rescanRequested, this, &AppController::onRescanRequested);
 
     m_mainWindow->setCentralWidget(m_mainScreen);
 }
@@ -136,11 +135,72 @@ void AppController::startAutoUpdate()
 
 void AppController::onAutoUpdate()
 {
+    // Status only: the rescan walks the roots on the GUI thread, so new or
+    // removed repositories wait for an explicit refresh
+    if (m_mainScreen) {
+        m_mainScreen->updateAllRepoStatus();
+    }
+}
+
+void AppController::onRescanRequested()
+{
+    // Root paths may have been edited in the config file since startup
+    if (Config::exists()) {
+        auto result = m_config.load();
+        if (result.isErr()) {
+            qWarning() << "Keeping previous configuration:" << result.error();
+        }
+    }
+    applyWorkerOptions();
+    rescanTree();
+}
+
+void AppController::rescanTree()
+{
+    if (!m_folderModel) return;
+
+    m_folderModel->setDiscoveryOptions(discoveryOptions());
+    m_folderModel->rescan(existingPaths(false));
     if (m_mainScreen) {
         m_mainScreen->updateAllRepoStatus();
     }
 }
 
+DiscoveryOptions AppController::discoveryOptions() const
+{
+    DiscoveryOptions options;
+    options.maxDepth = m_config.maxDepth;
+    options.exclude = m_config.exclude;
+    options.stopAtRepos = m_config.stopAtRepos;
+    options.submodules = m_config.submodules;
+    options.followSymlinks = m_config.followSymlinks;
+    return options;
+}
+
+void AppController::applyWorkerOptions()
+{
+    // Safe while the worker runs: tasks already queued pick them up
+    GitWorker::setOpenOptions(m_config.ceilingDirs, m_config.directGitDirOpen);
+    m_gitWorker->setConcurrency(m_config.concurrency);
+    // Submodules get rows of their own unless discovery stops at their parent
+    m_gitWorker->setSubmoduleRows(m_config.submodules || !m_config.stopAtRepos);
+}
+
+QStringList AppController::existingPaths(bool warn) const
+{
+    // Filter out non-existent paths
+    QStringList validPaths;
+    for (const QString& path : m_config.paths) {
+        if (QDir(path).exists()) {
+            validPaths.append(path);
+        } else if (warn) {
+            QMessageBox::warning(nullptr, "Invalid Path",
+                QString("The following path does not exist and will be skipped:\n%1").arg(path));
+        }
+    }
+    return validPaths;
+}
+
 void AppController::applyDarkTheme()
 {
     qApp->setStyle(QStyleFactory::create("Fusion"));
@@ -8,6 +8,7 @@
 #include "config/Config.h"
 #include "models/FolderTreeModel.h"
 #include "workers/GitWorker.h"
+#include "git/RepoWatcher.h"
 #include "screens/MainScreen.h"
 
 /**
@@ -25,11 +26,13 @@ public:
 
 private slots:
     void onAutoUpdate();
+    void onRescanRequested();
 
 private:
     Config m_config;
     FolderTreeModel* m_folderModel;
     GitWorker* m_gitWorker;
+    RepoWatcher* m_repoWatcher;
     MainScreen* m_mainScreen;
     QMainWindow* m_mainWindow;
     QTimer* m_autoUpdateTimer;
@@ -37,6 +40,10 @@ private:
     bool loadConfig();
     void setupMainWindow();
     void startAutoUpdate();
+    void rescanTree();
+    QStringList existingPaths(bool warn) const;
+    DiscoveryOptions discoveryOptions() const;
+    void applyWorkerOptions();
     void applyDarkTheme();
 };
 
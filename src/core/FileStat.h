@@ -0,0 +1,97 @@
+#ifndef FILESTAT_H
+#define FILESTAT_H
+
+#include <QString>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QHashFunctions>
+#include <QtGlobal>
+
+#ifndef Q_OS_WIN
+#include <sys/stat.h>
+#endif
+
+/**
+ * FileStamp - Minimal stat data used to detect filesystem changes
+ *
+ * Times are kept in nanoseconds so sub-second edits are not missed on
+ * filesystems that support it. The inode catches a file replaced by a
+ * rename, the ctime a write that restored the old mtime (touch -r, tar,
+ * rsync -t), as git does for its index.
+ */
+struct FileStamp {
+    qint64 mtimeNs = 0;
+    qint64 size = 0;
+    qint64 ctimeNs = 0;
+    quint64 inode = 0;
+
+    bool operator==(const FileStamp& other) const {
+        return mtimeNs == other.mtimeNs && size == other.size &&
+               ctimeNs == other.ctimeNs && inode == other.inode;
+    }
+    bool operator!=(const FileStamp& other) const { return !(*this == other); }
+};
+
+/**
+ * FileId - Identity of a file behind any number of symlinks or bind mounts
+ *
+ * Device and inode where stat() provides them; on Windows a hash of the
+ * canonical path stands in for the inode.
+ */
+struct FileId {
+    quint64 device = 0;
+    quint64 inode = 0;
+
+    bool operator==(const FileId& other) const {
+        return device == other.device && inode == other.inode;
+    }
+};
+
+inline size_t qHash(const FileId& id, size_t seed = 0)
+{
+    return ::qHash(id.device, seed) ^ ::qHash(id.inode, seed);
+}
+
+/**
+ * Stat a path without going through QFileInfo on platforms where a raw
+ * stat() is available. Returns false if the path does not exist.
+ */
+inline bool statPath(const QString& path, FileStamp* out, FileId* id = nullptr)
+{
+#ifdef Q_OS_WIN
+    QFileInfo info(path);
+    if (!info.exists()) {
+        return false;
+    }
+    out->mtimeNs = info.lastModified().toMSecsSinceEpoch() * 1000000;
+    out->size = info.isDir() ? 0 : info.size();
+    out->ctimeNs = info.metadataChangeTime().toMSecsSinceEpoch() * 1000000;
+    out->inode = ::qHash(info.canonicalFilePath());
+    if (id) {
+        id->inode = out->inode;
+    }
+    return true;
+#else
+    struct stat st;
+    if (::stat(QFile::encodeName(path).constData(), &st) != 0) {
+        return false;
+    }
+#ifdef Q_OS_MACOS
+    out->mtimeNs = qint64(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+    out->ctimeNs = qint64(st.st_ctimespec.tv_sec) * 1000000000 + st.st_ctimespec.tv_nsec;
+#else
+    out->mtimeNs = qint64(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    out->ctimeNs = qint64(st.st_ctim.tv_sec) * 1000000000 + st.st_ctim.tv_nsec;
+#endif
+    out->size = S_ISDIR(st.st_mode) ? 0 : qint64(st.st_size);
+    out->inode = quint64(st.st_ino);
+    if (id) {
+        id->device = quint64(st.st_dev);
+        id->inode = quint64(st.st_ino);
+    }
+    return true;
+#endif
+}
+
+#endif // FILESTAT_H
@@ -0,0 +1,186 @@
+#include "PathFilter.h"
+#include <QtAlgorithms>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PATHFILTER_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(PATHFILTER_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define PATHFILTER_AVX2
+#include <immintrin.h>
+#endif
+
+namespace {
+
+bool containsScalar(const char* s, qsizetype len, const QByteArray& needle)
+{
+    qsizetype n = needle.size();
+    const char* data = needle.constData();
+    for (qsizetype i = 0; i + n <= len; i++) {
+        if (s[i] == data[0] && std::memcmp(s + i, data, size_t(n)) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Candidates have the needle's first byte at i and its last at i + n - 1;
+// only those get a full compare of the bytes in between
+bool checkCandidates(quint32 mask, const char* s, qsizetype i, const QByteArray& needle)
+{
+    qsizetype n = needle.size();
+    while (mask) {
+        int bit = qCountTrailingZeroBits(mask);
+        if (n <= 2 || std::memcmp(s + i + bit + 1, needle.constData() + 1, size_t(n - 2)) == 0) {
+            return true;
+        }
+        mask &= mask - 1;
+    }
+    return false;
+}
+
+#ifdef PATHFILTER_SSE2
+bool containsSse2(const char* s, qsizetype len, const QByteArray& needle)
+{
+    qsizetype n = needle.size();
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[n - 1]);
+
+    qsizetype i = 0;
+    for (; i + n - 1 + 16 <= len; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + n - 1));
+        quint32 mask = quint32(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last))));
+        if (mask && checkCandidates(mask, s, i, needle)) {
+            return true;
+        }
+    }
+    return containsScalar(s + i, len - i, needle);
+}
+#endif
+
+#ifdef PATHFILTER_AVX2
+__attribute__((target("avx2")))
+bool containsAvx2(const char* s, qsizetype len, const QByteArray& needle)
+{
+    qsizetype n = needle.size();
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[n - 1]);
+
+    qsizetype i = 0;
+    for (; i + n - 1 + 32 <= len; i += 32) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i + n - 1));
+        quint32 mask = quint32(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last))));
+        if (mask && checkCandidates(mask, s, i, needle)) {
+            return true;
+        }
+    }
+    // Shorter tails still get one 16-byte step
+    return containsSse2(s + i, len - i, needle);
+}
+
+bool hasAvx2()
+{
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+#endif
+
+bool contains(const char* s, qsizetype len, const QByteArray& needle)
+{
+    if (needle.size() > len) {
+        return false;
+    }
+#ifdef PATHFILTER_AVX2
+    if (len >= 32 && hasAvx2()) {
+        return containsAvx2(s, len, needle);
+    }
+#endif
+#ifdef PATHFILTER_SSE2
+    return containsSse2(s, len, needle);
+#else
+    return containsScalar(s, len, needle);
+#endif
+}
+
+} // namespace
+
+PathFilter::PathFilter(const QByteArrayList& prefixes, const QByteArrayList& substrings)
+{
+    for (const QByteArray& text : prefixes) {
+        if (text.isEmpty()) continue;
+        Prefix prefix;
+        prefix.text = text;
+        std::memset(prefix.head, 0, sizeof(prefix.head));
+        std::memcpy(prefix.head, text.constData(), size_t(qMin(text.size(), qsizetype(16))));
+        prefix.mask = text.size() >= 16 ? 0xffffu : (1u << text.size()) - 1;
+        m_prefixes.append(prefix);
+    }
+    for (const QByteArray& text : substrings) {
+        if (!text.isEmpty()) {
+            m_substrings.append(text);
+        }
+    }
+}
+
+bool PathFilter::matches(const char* path, qsizetype length) const
+{
+    if (!m_prefixes.isEmpty()) {
+#ifdef PATHFILTER_SSE2
+        // One load serves every prefix; short paths are copied so the
+        // load never reads past their end
+        alignas(16) char padded[16];
+        const char* headPtr = path;
+        if (length < 16) {
+            std::memset(padded, 0, sizeof(padded));
+            std::memcpy(padded, path, size_t(length));
+            headPtr = padded;
+        }
+        __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i*>(headPtr));
+        for (const Prefix& prefix : m_prefixes) {
+            if (prefix.text.size() > length) continue;
+            __m128i want = _mm_load_si128(reinterpret_cast<const __m128i*>(prefix.head));
+            quint32 equal = quint32(_mm_movemask_epi8(_mm_cmpeq_epi8(head, want)));
+            if ((equal & prefix.mask) == prefix.mask &&
+                (prefix.text.size() <= 16 ||
+                 std::memcmp(path + 16, prefix.text.constData() + 16,
+                             size_t(prefix.text.size() - 16)) == 0)) {
+                return true;
+            }
+        }
+#else
+        for (const Prefix& prefix : m_prefixes) {
+            if (prefix.text.size() <= length &&
+                std::memcmp(path, prefix.text.constData(), size_t(prefix.text.size())) == 0) {
+                return true;
+            }
+        }
+#endif
+    }
+
+    for (const QByteArray& substring : m_substrings) {
+        if (contains(path, length, substring)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* PathFilter::kernelName()
+{
+#ifdef PATHFILTER_AVX2
+    if (hasAvx2()) {
+        return "avx2";
+    }
+#endif
+#ifdef PATHFILTER_SSE2
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
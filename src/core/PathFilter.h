@@ -0,0 +1,42 @@
+#ifndef PATHFILTER_H
+#define PATHFILTER_H
+
+#include <QByteArray>
+#include <QByteArrayList>
+#include <QVector>
+
+/**
+ * PathFilter - Literal prefix and substring matching on raw UTF-8 paths
+ *
+ * Meant to run on the char* paths handed out by libgit2, so that rejected
+ * paths are never converted to QString. Prefixes of up to 16 bytes are
+ * compared against the first 16 bytes of a path in one SSE2 compare each;
+ * substrings are searched 16 or 32 bytes at a time by matching their first
+ * and last byte, with a full compare only on candidates. AVX2 is picked at
+ * run time, other CPUs use scalar loops.
+ */
+class PathFilter {
+public:
+    PathFilter() = default;
+    PathFilter(const QByteArrayList& prefixes, const QByteArrayList& substrings);
+
+    bool isEmpty() const { return m_prefixes.isEmpty() && m_substrings.isEmpty(); }
+
+    // Path starts with one of the prefixes or contains one of the substrings
+    bool matches(const char* path, qsizetype length) const;
+
+    // "avx2", "sse2" or "scalar", for logs and benchmarks
+    static const char* kernelName();
+
+private:
+    struct Prefix {
+        QByteArray text;
+        alignas(16) char head[16];  // First 16 bytes, zero padded
+        quint32 mask;               // Movemask bits that must match
+    };
+
+    QVector<Prefix> m_prefixes;
+    QByteArrayList m_substrings;
+};
+
+#endif // PATHFILTER_H
@@ -0,0 +1,279 @@
+#include "StatEngine.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QGlobalStatic>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+#include <cerrno>
+
+#ifndef Q_OS_WIN
+#include <sys/stat.h>
+#endif
+
+#ifdef HAVE_IO_URING
+#include <liburing.h>
+#include <sys/sysmacros.h>
+#endif
+
+namespace {
+
+// Below this many paths, fanning out costs more than it hides
+const int InlineBatch = 32;
+
+#ifdef HAVE_IO_URING
+const unsigned RingDepth = 128;
+
+// Rings are not thread safe: one per calling thread, set up on first use
+struct Ring {
+    io_uring ring;
+    bool ready = false;
+    // Kept with the ring so a request still in flight never writes to a dead stack
+    struct statx buffers[RingDepth];
+
+    Ring() { ready = io_uring_queue_init(RingDepth, &ring, 0) == 0; }
+    ~Ring() {
+        if (ready) {
+            io_uring_queue_exit(&ring);
+        }
+    }
+};
+
+Ring& threadRing()
+{
+    thread_local Ring ring;
+    return ring;
+}
+
+// Kernels before 5.6, and sandboxes that filter io_uring_setup, cannot do it
+bool uringSupported()
+{
+    Ring& ring = threadRing();
+    if (!ring.ready) {
+        return false;
+    }
+    io_uring_probe* probe = io_uring_get_probe_ring(&ring.ring);
+    if (!probe) {
+        return false;
+    }
+    bool supported = io_uring_opcode_supported(probe, IORING_OP_STATX);
+    io_uring_free_probe(probe);
+    return supported;
+}
+
+void fillFromStatx(const struct statx& stx, StatResult* out)
+{
+    out->error = 0;
+    out->mode = stx.stx_mode;
+    out->size = qint64(stx.stx_size);
+    out->mtimeNs = qint64(stx.stx_mtime.tv_sec) * 1000000000 + stx.stx_mtime.tv_nsec;
+    out->ctimeNs = qint64(stx.stx_ctime.tv_sec) * 1000000000 + stx.stx_ctime.tv_nsec;
+    out->device = quint64(makedev(stx.stx_dev_major, stx.stx_dev_minor));
+    out->inode = quint64(stx.stx_ino);
+}
+#endif
+
+void statOne(int dirFd, const char* path, bool noFollow, StatResult* out)
+{
+    *out = StatResult();
+#ifdef Q_OS_WIN
+    Q_UNUSED(dirFd);
+    QFileInfo info(QFile::decodeName(path));
+    if (noFollow ? !info.exists() && !info.isSymLink() : !info.exists()) {
+        out->error = ENOENT;
+        return;
+    }
+    if (noFollow && info.isSymLink()) {
+        out->mode = 0120000;
+    } else {
+        out->mode = info.isDir() ? 0040000 : 0100000;
+    }
+    out->size = info.isDir() ? 0 : info.size();
+    out->mtimeNs = info.lastModified().toMSecsSinceEpoch() * 1000000;
+    out->ctimeNs = info.metadataChangeTime().toMSecsSinceEpoch() * 1000000;
+    out->inode = ::qHash(info.canonicalFilePath());
+#else
+    struct stat st;
+    if (::fstatat(dirFd, path, &st, noFollow ? AT_SYMLINK_NOFOLLOW : 0) != 0) {
+        out->error = errno;
+        return;
+    }
+    out->mode = quint32(st.st_mode);
+    out->size = qint64(st.st_size);
+#ifdef Q_OS_MACOS
+    out->mtimeNs = qint64(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+    out->ctimeNs = qint64(st.st_ctimespec.tv_sec) * 1000000000 + st.st_ctimespec.tv_nsec;
+#else
+    out->mtimeNs = qint64(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    out->ctimeNs = qint64(st.st_ctim.tv_sec) * 1000000000 + st.st_ctim.tv_nsec;
+#endif
+    out->device = quint64(st.st_dev);
+    out->inode = quint64(st.st_ino);
+#endif
+}
+
+StatEngine::Backend bestBackend()
+{
+#ifdef HAVE_IO_URING
+    if (uringSupported()) {
+        return StatEngine::IoUring;
+    }
+#endif
+    return StatEngine::ThreadPool;
+}
+
+} // namespace
+
+Q_GLOBAL_STATIC_WITH_ARGS(StatEngine, g_statEngine, (bestBackend()))
+
+StatEngine& StatEngine::instance()
+{
+    return *g_statEngine;
+}
+
+StatEngine::StatEngine(Backend backend)
+    : m_backend(backend)
+{
+#ifndef HAVE_IO_URING
+    if (m_backend == IoUring) {
+        m_backend = ThreadPool;
+    }
+#endif
+    if (m_backend != Serial) {
+        // Also the fallback when a thread cannot set up its ring.
+        // Stats wait on the filesystem, not the CPU: run more than one per core
+        m_pool = new QThreadPool();
+        m_pool->setMaxThreadCount(qBound(4, QThread::idealThreadCount() * 2, 16));
+    }
+}
+
+StatEngine::~StatEngine()
+{
+    delete m_pool;
+}
+
+const char* StatEngine::backendName(Backend backend)
+{
+    switch (backend) {
+    case Serial: return "serial";
+    case ThreadPool: return "thread pool";
+    case IoUring: return "io_uring";
+    }
+    return "unknown";
+}
+
+void StatEngine::stat(int dirFd, const char* const* paths, int count, StatResult* out,
+                      bool noFollow) const
+{
+    if (count <= 0) {
+        return;
+    }
+    if (count < InlineBatch || m_backend == Serial) {
+        statSerial(dirFd, paths, count, out, noFollow);
+        return;
+    }
+    if (m_backend == IoUring && statUring(dirFd, paths, count, out, noFollow)) {
+        return;
+    }
+    if (m_pool) {
+        statThreaded(dirFd, paths, count, out, noFollow);
+    } else {
+        statSerial(dirFd, paths, count, out, noFollow);
+    }
+}
+
+void StatEngine::statSerial(int dirFd, const char* const* paths, int count, StatResult* out,
+                            bool noFollow) const
+{
+    for (int i = 0; i < count; i++) {
+        statOne(dirFd, paths[i], noFollow, &out[i]);
+    }
+}
+
+void StatEngine::statThreaded(int dirFd, const char* const* paths, int count, StatResult* out,
+                              bool noFollow) const
+{
+    // Contiguous slices of at least InlineBatch paths, one task each
+    int tasks = qMin(m_pool->maxThreadCount(), (count + InlineBatch - 1) / InlineBatch);
+    int slice = (count + tasks - 1) / tasks;
+
+    QSemaphore done;
+    int started = 0;
+    for (int begin = 0; begin < count; begin += slice) {
+        int n = qMin(slice, count - begin);
+        m_pool->start([=, &done]() {
+            statSerial(dirFd, paths + begin, n, out + begin, noFollow);
+            done.release();
+        });
+        started++;
+    }
+    done.acquire(started);
+}
+
+bool StatEngine::statUring(int dirFd, const char* const* paths, int count, StatResult* out,
+                           bool noFollow) const
+{
+#ifdef HAVE_IO_URING
+    Ring& ring = threadRing();
+    if (!ring.ready) {
+        return false;
+    }
+
+    int flags = noFollow ? AT_SYMLINK_NOFOLLOW : 0;
+    unsigned mask = STATX_TYPE | STATX_MODE | STATX_SIZE | STATX_MTIME | STATX_CTIME | STATX_INO;
+    struct statx* buffers = ring.buffers;
+
+    for (int base = 0; base < count; base += int(RingDepth)) {
+        int n = qMin(int(RingDepth), count - base);
+        for (int i = 0; i < n; i++) {
+            // The ring holds RingDepth entries and is drained below
+            io_uring_sqe* sqe = io_uring_get_sqe(&ring.ring);
+            io_uring_prep_statx(sqe, dirFd, paths[base + i], flags, mask, &buffers[i]);
+            sqe->user_data = quint64(i);
+        }
+
+        int submitted = io_uring_submit(&ring.ring);
+        if (submitted != n) {
+            // Entries left in the queue would go out with the next batch
+            ring.ready = false;
+            submitted = qMax(submitted, 0);
+        }
+        for (int reaped = 0; reaped < submitted; reaped++) {
+            io_uring_cqe* cqe = nullptr;
+            int rc;
+            do {
+                rc = io_uring_wait_cqe(&ring.ring, &cqe);
+            } while (rc == -EINTR);
+            if (rc < 0) {
+                // Ring unusable from here on; the rest is done without it
+                ring.ready = false;
+                statSerial(dirFd, paths + base, count - base, out + base, noFollow);
+                return true;
+            }
+            int i = int(cqe->user_data);
+            if (cqe->res < 0) {
+                out[base + i] = StatResult();
+                out[base + i].error = -cqe->res;
+            } else {
+                fillFromStatx(buffers[i], &out[base + i]);
+            }
+            io_uring_cqe_seen(&ring.ring, cqe);
+        }
+        if (!ring.ready) {
+            // Whatever the kernel did not take is stated directly
+            statSerial(dirFd, paths + base + submitted, count - base - submitted,
+                       out + base + submitted, noFollow);
+            return true;
+        }
+    }
+    return true;
+#else
+    Q_UNUSED(dirFd);
+    Q_UNUSED(paths);
+    Q_UNUSED(count);
+    Q_UNUSED(out);
+    Q_UNUSED(noFollow);
+    return false;
+#endif
+}
@@ -0,0 +1,71 @@
+#include "Utf8List.h"
+#include <QAnyStringView>
+#include <algorithm>
+#include <numeric>
+
+Utf8List Utf8List::fromStringList(const QStringList& list)
+{
+    Utf8List out;
+    for (const QString& item : list) {
+        out.append(item.toUtf8());
+    }
+    return out;
+}
+
+void Utf8List::append(const char* data, qsizetype length)
+{
+    m_offsets.append(m_buffer.size());
+    m_buffer.append(data, length);
+    m_buffer.append('\0');
+}
+
+void Utf8List::reserve(int count, qsizetype bytes)
+{
+    m_offsets.reserve(count);
+    m_buffer.reserve(bytes + count);
+}
+
+qsizetype Utf8List::length(int i) const
+{
+    qsizetype end = i + 1 < m_offsets.size() ? m_offsets[i + 1] : m_buffer.size();
+    return end - m_offsets[i] - 1;
+}
+
+QStringList Utf8List::toStringList() const
+{
+    QStringList out;
+    out.reserve(size());
+    for (int i = 0; i < size(); i++) {
+        out.append(at(i));
+    }
+    return out;
+}
+
+void Utf8List::sortCaseInsensitive()
+{
+    // Both orders agree on ASCII, so the cheap one is kept for the common case
+    QVector<bool> ascii(size());
+    for (int i = 0; i < size(); i++) {
+        const char* item = data(i);
+        ascii[i] = std::all_of(item, item + length(i), [](char c) { return uchar(c) < 0x80; });
+    }
+
+    QVector<int> order(size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this, &ascii](int a, int b) {
+        if (ascii[a] && ascii[b]) {
+            // Items are NUL-terminated, so qstricmp never reads past one
+            return qstricmp(data(a), data(b)) < 0;
+        }
+        return QAnyStringView::compare(QUtf8StringView(data(a), length(a)),
+                                       QUtf8StringView(data(b), length(b)),
+                                       Qt::CaseInsensitive) < 0;
+    });
+
+    Utf8List sorted;
+    sorted.reserve(size(), m_buffer.size());
+    for (int i : order) {
+        sorted.append(data(i), length(i));
+    }
+    *this = sorted;
+}
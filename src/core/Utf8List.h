@@ -0,0 +1,52 @@
+#ifndef UTF8LIST_H
+#define UTF8LIST_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QMetaType>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * Utf8List - List of UTF-8 strings packed into one buffer
+ *
+ * Strings are appended as raw bytes, each followed by a NUL so data(i) can
+ * go straight back to libgit2, and located through an offset table. Two
+ * allocations hold the whole list whatever its length; copies share them.
+ * QString is only produced on demand, per item, by at().
+ */
+class Utf8List {
+public:
+    Utf8List() = default;
+
+    static Utf8List fromStringList(const QStringList& list);
+
+    void append(const char* data, qsizetype length);
+    void append(QByteArrayView bytes) { append(bytes.data(), bytes.size()); }
+    void reserve(int count, qsizetype bytes);
+
+    int size() const { return m_offsets.size(); }
+    bool isEmpty() const { return m_offsets.isEmpty(); }
+
+    // NUL-terminated item, valid while this list is alive and unchanged
+    const char* data(int i) const { return m_buffer.constData() + m_offsets[i]; }
+    QByteArrayView view(int i) const { return QByteArrayView(data(i), length(i)); }
+    qsizetype length(int i) const;
+
+    // Decoded item
+    QString at(int i) const { return QString::fromUtf8(data(i), length(i)); }
+    QStringList toStringList() const;
+
+    // Case-insensitive order, Unicode case folding for non-ASCII names,
+    // stable for names equal but for case
+    void sortCaseInsensitive();
+
+private:
+    QByteArray m_buffer;
+    QVector<qsizetype> m_offsets;   // Start of each item in m_buffer
+};
+
+Q_DECLARE_METATYPE(Utf8List)
+
+#endif // UTF8LIST_H
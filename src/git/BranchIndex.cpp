@@ -0,0 +1,119 @@
+#include "BranchIndex.h"
+#include <QMutexLocker>
+#include <algorithm>
+#include "git/RefReader.h"
+
+namespace {
+
+bool lessCaseInsensitive(const QString& a, const QString& b)
+{
+    int c = QString::compare(a, b, Qt::CaseInsensitive);
+    return c != 0 ? c < 0 : a < b;
+}
+
+} // namespace
+
+BranchList BranchIndex::branches(const QString& repoPath)
+{
+    quint64 generation = RefReader::branchesGeneration(repoPath);
+
+    QMutexLocker locker(&m_mutex);
+    Entry& entry = m_entries[repoPath];
+    if (generation != 0 && entry.generation == generation) {
+        return entry.lists;
+    }
+
+    // Names come from RefReader's own cache, only changed dirs are re-listed
+    update(&entry, RefReader::localBranches(repoPath), RefReader::remoteBranches(repoPath));
+    entry.generation = generation;
+    return entry.lists;
+}
+
+void BranchIndex::invalidate(const QString& repoPath)
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.remove(repoPath);
+}
+
+void BranchIndex::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+}
+
+QString BranchIndex::remoteBranchName(const QString& remoteRef)
+{
+    // "origin/feature" -> "feature", other remotes keep their prefix
+    return remoteRef.startsWith("origin/") ? remoteRef.mid(7) : remoteRef;
+}
+
+void BranchIndex::insertSorted(QStringList* list, const QString& name)
+{
+    list->insert(std::lower_bound(list->begin(), list->end(), name, lessCaseInsensitive), name);
+}
+
+void BranchIndex::removeSorted(QStringList* list, const QString& name)
+{
+    auto it = std::lower_bound(list->begin(), list->end(), name, lessCaseInsensitive);
+    if (it != list->end() && *it == name) {
+        list->erase(it);
+    }
+}
+
+void BranchIndex::update(Entry* entry, const QStringList& local, const QStringList& remote)
+{
+    QSet<QString> newLocal(local.begin(), local.end());
+    QHash<QString, int> newRemote;
+    for (const QString& ref : remote) {
+        newRemote[remoteBranchName(ref)]++;
+    }
+
+    // First build: one sort instead of n insertions
+    if (entry->local.isEmpty() && entry->remote.isEmpty()) {
+        entry->lists.local = QStringList(newLocal.begin(), newLocal.end());
+        for (auto it = newRemote.constBegin(); it != newRemote.constEnd(); ++it) {
+            if (!newLocal.contains(it.key())) {
+                entry->lists.remoteOnly.append(it.key());
+            }
+        }
+        std::sort(entry->lists.local.begin(), entry->lists.local.end(), lessCaseInsensitive);
+        std::sort(entry->lists.remoteOnly.begin(), entry->lists.remoteOnly.end(), lessCaseInsensitive);
+        entry->local = newLocal;
+        entry->remote = newRemote;
+        return;
+    }
+
+    // Keeps remoteOnly == remote names minus local names. A remote name
+    // hidden by a local branch shows up again when that branch is deleted;
+    // names handled by the local pass are skipped by the remote pass.
+    for (const QString& name : entry->local) {
+        if (!newLocal.contains(name)) {
+            removeSorted(&entry->lists.local, name);
+            if (newRemote.contains(name)) {
+                insertSorted(&entry->lists.remoteOnly, name);
+            }
+        }
+    }
+    for (const QString& name : newLocal) {
+        if (!entry->local.contains(name)) {
+            insertSorted(&entry->lists.local, name);
+            if (entry->remote.contains(name)) {
+                removeSorted(&entry->lists.remoteOnly, name);
+            }
+        }
+    }
+
+    for (auto it = entry->remote.constBegin(); it != entry->remote.constEnd(); ++it) {
+        if (!newRemote.contains(it.key()) && !newLocal.contains(it.key()) && !entry->local.contains(it.key())) {
+            removeSorted(&entry->lists.remoteOnly, it.key());
+        }
+    }
+    for (auto it = newRemote.constBegin(); it != newRemote.constEnd(); ++it) {
+        if (!entry->remote.contains(it.key()) && !newLocal.contains(it.key()) && !entry->local.contains(it.key())) {
+            insertSorted(&entry->lists.remoteOnly, it.key());
+        }
+    }
+
+    entry->local = newLocal;
+    entry->remote = newRemote;
+}
@@ -0,0 +1,59 @@
+#ifndef BRANCHINDEX_H
+#define BRANCHINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+
+/**
+ * BranchList - Branch names of a repository as shown in the branch selector
+ *
+ * Both lists are sorted case-insensitively. remoteOnly holds remote
+ * branches ("origin/" stripped) that have no local branch of the same name.
+ */
+struct BranchList {
+    QStringList local;
+    QStringList remoteOnly;
+};
+
+/**
+ * BranchIndex - Per-repository branch lists, built once and kept in sync
+ *
+ * A lookup first asks RefReader whether any refs directory or packed-refs
+ * changed since the last one. If not, the stored lists are returned as is.
+ * Otherwise the new ref names are diffed against the indexed ones and only
+ * the added or removed names are inserted into or taken out of the sorted
+ * lists, so a fetch that brings a few CI branches does not re-sort
+ * thousands.
+ *
+ * Thread-safe: GitWorker reads it from its thread and from batch jobs.
+ */
+class BranchIndex {
+public:
+    BranchIndex() = default;
+
+    BranchList branches(const QString& repoPath);
+
+    void invalidate(const QString& repoPath);
+    void clear();
+
+private:
+    struct Entry {
+        quint64 generation = 0;
+        QSet<QString> local;
+        QHash<QString, int> remote;     // stripped name -> number of remotes carrying it
+        BranchList lists;
+    };
+
+    QMutex m_mutex;
+    QHash<QString, Entry> m_entries;
+
+    static QString remoteBranchName(const QString& remoteRef);
+    static void insertSorted(QStringList* list, const QString& name);
+    static void removeSorted(QStringList* list, const QString& name);
+    static void update(Entry* entry, const QStringList& local, const QStringList& remote);
+};
+
+#endif // BRANCHINDEX_H
@@ -1,16 +1,13 @@
 #include "GitRepository.h"
 #include <QDir>
-#include <QFile>
-#include <QTextStream>
-#include <QDirIterator>
+#include "git/RefReader.h"
 
 GitRepository::GitRepository(const QString& path)
     : m_path(path)
     , m_isValid(false)
 {
     // Check if this is a valid git repository
-    QString gitDir = getGitDir();
-    m_isValid = QDir(gitDir).exists();
+    m_isValid = RefReader::resolveGitDir(m_path).isValid();
 }
 
 GitRepository::~GitRepository()
@@ -24,27 +21,13 @@ QString GitRepository::name() const
 
 QString GitRepository::getGitDir() const
 {
-    return QDir(m_path).filePath(".git");
-}
-
-QString GitRepository::readFile(const QString& relativePath) const
-{
-    QString fullPath = QDir(getGitDir()).filePath(relativePath);
-    QFile file(fullPath);
-
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        return QString();
-    }
-
-    QTextStream stream(&file);
-    QString content = stream.readAll().trimmed();
-    file.close();
-    return content;
+    return RefReader::resolveGitDir(m_path).gitDir;
 }
 
 bool GitRepository::isGitRepository(const QString& path)
 {
-    return QDir(QDir(path).filePath(".git")).exists();
+    // .git may be a directory or a "gitdir:" file (worktree, submodule)
+    return RefReader::resolveGitDir(path).isValid();
 }
 
 Result<QString, QString> GitRepository::getCurrentBranch() const
@@ -53,19 +36,7 @@ Result<QString, QString> GitRepository::getCurrentBranch() const
         return Result<QString, QString>::Err("Invalid repository");
     }
 
-    QString head = readFile("HEAD");
-    if (head.isEmpty()) {
-        return Result<QString, QString>::Err("Cannot read HEAD");
-    }
-
-    // HEAD format: "ref: refs/heads/branch_name"
-    if (head.startsWith("ref: refs/heads/")) {
-        QString branch = head.mid(16);  // Remove "ref: refs/heads/"
-        return Result<QString, QString>::Ok(branch);
-    }
-
-    // Detached HEAD state (raw commit hash)
-    return Result<QString, QString>::Err("Detached HEAD - checkout a branch");
+    return RefReader::currentBranch(m_path);
 }
 
 Result<QStringList, QString> GitRepository::getLocalBranches() const
@@ -74,21 +45,8 @@ Result<QStringList, QString> GitRepository::getLocalBranches() const
         return Result<QStringList, QString>::Err("Invalid repository");
     }
 
-    QStringList branches;
-    QString headsPath = QDir(getGitDir()).filePath("refs/heads");
-    QDir headsDir(headsPath);
-
-    if (!headsDir.exists()) {
-        return Result<QStringList, QString>::Ok(branches);
-    }
-
-    QDirIterator it(headsPath, QDir::Files, QDirIterator::Subdirectories);
-    while (it.hasNext()) {
-        it.next();
-        QString relativePath = headsDir.relativeFilePath(it.filePath());
-        branches.append(relativePath);
-    }
-
+    // Loose and packed refs
+    QStringList branches = RefReader::localBranches(m_path);
     branches.sort(Qt::CaseInsensitive);
     return Result<QStringList, QString>::Ok(branches);
 }
@@ -99,24 +57,7 @@ Result<QStringList, QString> GitRepository::getRemoteBranches() const
         return Result<QStringList, QString>::Err("Invalid repository");
     }
 
-    QStringList branches;
-    QString remotesPath = QDir(getGitDir()).filePath("refs/remotes");
-    QDir remotesDir(remotesPath);
-
-    if (!remotesDir.exists()) {
-        return Result<QStringList, QString>::Ok(branches);
-    }
-
-    QDirIterator it(remotesPath, QDir::Files, QDirIterator::Subdirectories);
-    while (it.hasNext()) {
-        it.next();
-        QString relativePath = remotesDir.relativeFilePath(it.filePath());
-        // Skip HEAD references
-        if (!relativePath.endsWith("/HEAD")) {
-            branches.append(relativePath);
-        }
-    }
-
+    QStringList branches = RefReader::remoteBranches(m_path);
     branches.sort(Qt::CaseInsensitive);
     return Result<QStringList, QString>::Ok(branches);
 }
@@ -41,7 +41,6 @@ private:
     QString m_path;
     bool m_isValid;
 
-    QString readFile(const QString& relativePath) const;
     QString getGitDir() const;
 };
 
@@ -0,0 +1,400 @@
+#include "IndexReader.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QtEndian>
+#include <cerrno>
+#include <cstring>
+#include "RefReader.h"
+#include "core/FileStat.h"
+#include "core/StatEngine.h"
+
+#ifndef Q_OS_WIN
+#include <climits>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// On-disk entry layout (index versions 2 and 3)
+const int HeaderSize = 12;
+const int HashSize = 20;
+const int CtimeOffset = 0;
+const int MtimeOffset = 8;
+const int InodeOffset = 20;
+const int ModeOffset = 24;
+const int SizeOffset = 36;
+const int FlagsOffset = 60;
+const int NameOffset = 62;
+
+const quint16 AssumeValid = 0x8000;
+const quint16 Extended = 0x4000;
+const quint16 StageMask = 0x3000;
+const quint16 NameMask = 0x0fff;
+const quint16 SkipWorktree = 0x4000;
+const quint16 IntentToAdd = 0x2000;
+
+const quint32 TypeMask = 0170000;
+const quint32 TypeFile = 0100000;
+const quint32 TypeLink = 0120000;
+const quint32 TypeGitlink = 0160000;
+const quint32 ExecBit = 0100;
+
+inline quint32 be32(const uchar* p) { return qFromBigEndian<quint32>(p); }
+inline quint16 be16(const uchar* p) { return qFromBigEndian<quint16>(p); }
+
+// Entries stated per engine call; bounds the stack, not the index size
+const int StatBatch = 512;
+
+// Lowercased text of a config file, empty if absent
+QByteArray readConfig(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll().toLower() + '\n';
+}
+
+// Settings that make checked-out files differ from their blobs. Matched
+// loosely on purpose: a false hit only costs a content compare.
+bool configHasFilters(const QByteArray& text)
+{
+    return text.contains("autocrlf") || text.contains("eol") || text.contains("filter");
+}
+
+// Last value of a [core] key in lowercased config text, empty if unset.
+// Includes and conditional sections are not followed.
+QByteArray coreSetting(const QByteArray& text, const QByteArray& key)
+{
+    QByteArray value;
+    bool inCore = false;
+    for (QByteArray line : text.split('\n')) {
+        for (char mark : {'#', ';'}) {
+            int comment = line.indexOf(mark);
+            if (comment >= 0) {
+                line.truncate(comment);
+            }
+        }
+        line = line.trimmed();
+        if (line.startsWith('[')) {
+            inCore = line.startsWith("[core]");
+            continue;
+        }
+        int eq = line.indexOf('=');
+        if (!inCore || (eq < 0 ? line : line.left(eq)).trimmed() != key) {
+            continue;
+        }
+        // A bare key is a boolean true
+        value = eq < 0 ? QByteArray("true") : line.mid(eq + 1).trimmed();
+    }
+    return value;
+}
+
+bool isFalse(const QByteArray& value)
+{
+    return value == "false" || value == "no" || value == "off" || value == "0";
+}
+
+} // namespace
+
+bool IndexReader::open(const QString& workdir)
+{
+    close();
+
+#ifdef Q_OS_WIN
+    Q_UNUSED(workdir);
+    return false;
+#else
+    GitDirInfo dirs = RefReader::resolveGitDir(workdir);
+    if (!dirs.isValid()) {
+        return false;
+    }
+
+    // SHA-256 repositories use wider entries
+    QByteArray repoConfig = readConfig(QDir(dirs.commonDir).filePath("config"));
+    if (repoConfig.contains("objectformat")) {
+        return false;
+    }
+
+    // System, user and repository settings, later ones win, plus attribute
+    // files outside the index; tracked .gitattributes are spotted while
+    // validating below
+    QString home = QDir::homePath();
+    QByteArray xdg = qgetenv("XDG_CONFIG_HOME");
+    QString xdgConfig = xdg.isEmpty() ? QDir(home).filePath(".config") : QFile::decodeName(xdg);
+    QByteArray settings = readConfig(QStringLiteral("/etc/gitconfig")) +
+                          readConfig(QDir(xdgConfig).filePath("git/config")) +
+                          readConfig(QDir(home).filePath(".gitconfig")) +
+                          repoConfig;
+    bool filtered = configHasFilters(settings) ||
+                    QFileInfo::exists(QDir(dirs.commonDir).filePath("info/attributes")) ||
+                    QFileInfo::exists(QDir(xdgConfig).filePath("git/attributes"));
+
+    QString indexPath = QDir(dirs.gitDir).filePath("index");
+    FileStamp stamp;
+    if (!statPath(indexPath, &stamp)) {
+        return false;
+    }
+
+    m_file.setFileName(indexPath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    m_size = m_file.size();
+    if (m_size < HeaderSize + HashSize) {
+        close();
+        return false;
+    }
+    m_data = m_file.map(0, m_size);
+    if (!m_data || std::memcmp(m_data, "DIRC", 4) != 0) {
+        close();
+        return false;
+    }
+
+    // Version 4 prefix-compresses paths, which rules out in-place names
+    quint32 version = be32(m_data + 4);
+    quint32 count = be32(m_data + 8);
+    if ((version != 2 && version != 3) || count > quint32(INT_MAX)) {
+        close();
+        return false;
+    }
+
+    // Validate every entry once so scan() can trust the layout
+    const qint64 end = m_size - HashSize;
+    qint64 pos = HeaderSize;
+    for (quint32 i = 0; i < count; i++) {
+        if (pos + NameOffset + 1 > end) {
+            close();
+            return false;
+        }
+        const uchar* entry = m_data + pos;
+        quint16 flags = be16(entry + FlagsOffset);
+        qint64 nameOffset = NameOffset;
+        if (flags & Extended) {
+            if (version < 3) {
+                close();
+                return false;
+            }
+            nameOffset += 2;
+        }
+        const uchar* name = entry + nameOffset;
+        const void* nul = pos + nameOffset < end
+            ? std::memchr(name, 0, size_t(end - pos - nameOffset)) : nullptr;
+        if (!nul) {
+            close();
+            return false;
+        }
+        qint64 nameLen = static_cast<const uchar*>(nul) - name;
+        if ((flags & NameMask) != NameMask && nameLen != (flags & NameMask)) {
+            close();
+            return false;
+        }
+        const qint64 attrLen = 14;   // ".gitattributes"
+        if (nameLen >= attrLen &&
+            std::memcmp(name + nameLen - attrLen, ".gitattributes", size_t(attrLen)) == 0 &&
+            (nameLen == attrLen || name[nameLen - attrLen - 1] == '/')) {
+            filtered = true;
+        }
+        pos += (nameOffset + nameLen + 8) & ~qint64(7);
+    }
+    if (pos > end) {
+        close();
+        return false;
+    }
+
+    // Split index keeps most entries in a shared file, sparse index
+    // collapses directories into single entries; neither maps to files here
+    while (pos + 8 <= end) {
+        const uchar* ext = m_data + pos;
+        if (std::memcmp(ext, "link", 4) == 0 || std::memcmp(ext, "sdir", 4) == 0) {
+            close();
+            return false;
+        }
+        pos += 8 + qint64(be32(ext + 4));
+    }
+    if (pos != end) {
+        close();
+        return false;
+    }
+
+    m_entryCount = int(count);
+    m_indexMtimeNs = stamp.mtimeNs;
+    m_filtered = filtered;
+    m_trustFilemode = !isFalse(coreSetting(settings, "filemode"));
+    m_trustCtime = !isFalse(coreSetting(settings, "trustctime"));
+    m_checkInode = coreSetting(settings, "checkstat") != "minimal";
+    return true;
+#endif
+}
+
+void IndexReader::close()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar*>(m_data));
+        m_data = nullptr;
+    }
+    m_file.close();
+    m_size = 0;
+    m_entryCount = 0;
+    m_indexMtimeNs = 0;
+    m_filtered = false;
+    m_trustFilemode = true;
+    m_trustCtime = true;
+    m_checkInode = true;
+}
+
+IndexReader::Scan IndexReader::scan(const QString& workdir, QStringList* dirtyPaths,
+                                    int maxPaths) const
+{
+#ifdef Q_OS_WIN
+    Q_UNUSED(workdir);
+    Q_UNUSED(dirtyPaths);
+    Q_UNUSED(maxPaths);
+    return Unsupported;
+#else
+    if (!m_data) {
+        return Unsupported;
+    }
+
+    int rootFd = ::open(QFile::encodeName(workdir).constData(),
+                        O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (rootFd < 0) {
+        return Unsupported;
+    }
+
+    // Entries waiting for their stat, flushed through the engine in batches.
+    // Names are NUL-terminated in the mapping and relative to rootFd.
+    const uchar* pending[StatBatch];
+    const char* names[StatBatch];
+    StatResult stats[StatBatch];
+    int pendingCount = 0;
+
+    const StatEngine& engine = StatEngine::instance();
+    Scan result = Clean;
+    bool done = false;
+
+    auto report = [&](const char* name, size_t nameLen) {
+        result = Dirty;
+        if (!dirtyPaths) {
+            done = true;
+            return;
+        }
+        QString path = QString::fromUtf8(name, qsizetype(nameLen));
+        // Unmerged paths have one entry per stage
+        if (dirtyPaths->isEmpty() || dirtyPaths->last() != path) {
+            dirtyPaths->append(path);
+        }
+        done = dirtyPaths->size() >= maxPaths;
+    };
+
+    auto flush = [&]() {
+        engine.stat(rootFd, names, pendingCount, stats, true);
+        for (int i = 0; i < pendingCount && !done; i++) {
+            Scan check = compare(pending[i], stats[i]);
+            if (check == Dirty) {
+                report(names[i], std::strlen(names[i]));
+            } else if (check == MaybeDirty) {
+                result = MaybeDirty;
+            }
+        }
+        pendingCount = 0;
+    };
+
+    const uchar* entry = m_data + HeaderSize;
+    for (int i = 0; i < m_entryCount && !done; i++) {
+        quint16 flags = be16(entry + FlagsOffset);
+        quint16 extFlags = 0;
+        int nameOffset = NameOffset;
+        if (flags & Extended) {
+            extFlags = be16(entry + NameOffset);
+            nameOffset += 2;
+        }
+        const char* name = reinterpret_cast<const char*>(entry + nameOffset);
+        size_t nameLen = flags & NameMask;
+        if (nameLen == NameMask) {
+            nameLen = std::strlen(name);
+        }
+        const uchar* current = entry;
+        entry += (nameOffset + nameLen + 8) & ~size_t(7);
+
+        quint32 mode = be32(current + ModeOffset);
+        if ((mode & TypeMask) == TypeGitlink || (flags & AssumeValid) ||
+            (extFlags & SkipWorktree)) {
+            continue;
+        }
+
+        if ((flags & StageMask) || (extFlags & IntentToAdd)) {
+            // Earlier entries first, so paths come out in index order
+            if (pendingCount > 0) {
+                flush();
+            }
+            if (!done) {
+                report(name, nameLen);
+            }
+            continue;
+        }
+
+        pending[pendingCount] = current;
+        names[pendingCount] = name;
+        if (++pendingCount == StatBatch) {
+            flush();
+        }
+    }
+    if (pendingCount > 0 && !done) {
+        flush();
+    }
+
+    ::close(rootFd);
+    return result;
+#endif
+}
+
+IndexReader::Scan IndexReader::compare(const uchar* entry, const StatResult& st) const
+{
+    if (st.error == ENOENT || st.error == ENOTDIR) {
+        return Dirty;
+    }
+    if (st.error != 0) {
+        return MaybeDirty;
+    }
+
+    quint32 mode = be32(entry + ModeOffset);
+    quint32 type = st.mode & TypeMask;
+    if (type != (mode & TypeMask) || (type != TypeFile && type != TypeLink)) {
+        return Dirty;
+    }
+
+    // chmod +x is a change of its own, whatever the content
+    if (type == TypeFile && m_trustFilemode && (mode & ExecBit) != (st.mode & ExecBit)) {
+        return Dirty;
+    }
+
+    quint32 cachedSize = be32(entry + SizeOffset);
+    if (cachedSize != quint32(st.size)) {
+        // Racily-clean entries are written with size 0 to force a compare;
+        // with filters the rewritten copy may normalise back to the blob
+        return cachedSize != 0 && !m_filtered ? Dirty : MaybeDirty;
+    }
+
+    qint64 mtimeSec = be32(entry + MtimeOffset);
+    qint64 mtimeNsec = be32(entry + MtimeOffset + 4);
+    // Writers built without nanosecond support store 0
+    bool sameTime = mtimeSec == st.mtimeNs / 1000000000 &&
+                    (mtimeNsec == 0 || mtimeNsec == st.mtimeNs % 1000000000);
+    if (!sameTime || mtimeSec * 1000000000 + mtimeNsec >= m_indexMtimeNs) {
+        return MaybeDirty;
+    }
+
+    // Like git: a ctime or inode change (touch -r, a replaced file) may
+    // hide an edit behind restored timestamps. Inodes are stored truncated.
+    qint64 ctimeSec = be32(entry + CtimeOffset);
+    qint64 ctimeNsec = be32(entry + CtimeOffset + 4);
+    bool sameCtime = ctimeSec == st.ctimeNs / 1000000000 &&
+                     (ctimeNsec == 0 || ctimeNsec == st.ctimeNs % 1000000000);
+    if ((m_trustCtime && !sameCtime) ||
+        (m_checkInode && be32(entry + InodeOffset) != quint32(st.inode))) {
+        return MaybeDirty;
+    }
+    return Clean;
+}
@@ -0,0 +1,70 @@
+#ifndef INDEXREADER_H
+#define INDEXREADER_H
+
+#include <QFile>
+#include <QString>
+#include <QStringList>
+
+struct StatResult;
+
+/**
+ * IndexReader - Stat-only comparison of the git index against the workdir
+ *
+ * Maps the index file and walks its entries in place, comparing the cached
+ * stat data of every tracked file with a fresh stat of the workdir copy.
+ * Names are passed to StatEngine straight from the mapping, relative to an
+ * fd of the workdir, in fixed-size batches. Nothing is allocated per
+ * entry; only reported dirty paths are decoded.
+ *
+ * Only index versions 2 and 3 without split-index or sparse-index
+ * extensions are read. Anything else opens as unsupported and callers fall
+ * back to libgit2. The index knows nothing about untracked files.
+ *
+ * With content filters configured (autocrlf, eol, filter drivers or any
+ * .gitattributes) a file rewritten to another size may still be clean once
+ * filtered, so a size mismatch only counts as MaybeDirty there.
+ *
+ * As in git, core.filemode makes a flipped exec bit Dirty, and a changed
+ * ctime or inode (core.trustctime, core.checkStat) MaybeDirty.
+ */
+class IndexReader {
+public:
+    enum Scan {
+        Clean,          // Every tracked file matches its cached stat data
+        MaybeDirty,     // Timestamps differ or are racy, content must be compared
+        Dirty,          // A tracked file is missing, resized (no filters), retyped, chmod'ed or unmerged
+        Unsupported     // Not opened, or the workdir cannot be read
+    };
+
+    IndexReader() = default;
+    ~IndexReader() { close(); }
+
+    // Map the index of the repository at workdir, false if absent or unusual
+    bool open(const QString& workdir);
+    void close();
+
+    int entryCount() const { return m_entryCount; }
+    bool hasFilters() const { return m_filtered; }
+
+    // Compare tracked files with the workdir. Stops at the first dirty file
+    // unless dirtyPaths is given, which then collects up to maxPaths of them.
+    Scan scan(const QString& workdir, QStringList* dirtyPaths = nullptr, int maxPaths = 1) const;
+
+private:
+    Q_DISABLE_COPY(IndexReader)
+
+    // Verdict for one stage-0 entry against its workdir stat
+    Scan compare(const uchar* entry, const StatResult& st) const;
+
+    QFile m_file;
+    const uchar* m_data = nullptr;
+    qint64 m_size = 0;
+    int m_entryCount = 0;
+    qint64 m_indexMtimeNs = 0;      // Entries this recent are racily clean
+    bool m_filtered = false;        // Workdir copies may differ from blobs in size
+    bool m_trustFilemode = true;    // core.filemode: the exec bit is compared
+    bool m_trustCtime = true;       // core.trustctime
+    bool m_checkInode = true;       // core.checkstat other than "minimal"
+};
+
+#endif // INDEXREADER_H
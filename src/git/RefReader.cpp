@@ -0,0 +1,386 @@
+#include "RefReader.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QGlobalStatic>
+#include <algorithm>
+#include <cstring>
+#include "core/FileStat.h"
+
+namespace {
+
+struct CachedFile {
+    FileStamp stamp;
+    QByteArray content;
+    bool exists = false;
+    bool loaded = false;
+};
+
+struct CachedDir {
+    FileStamp stamp;
+    QStringList files;
+    QStringList dirs;
+};
+
+struct PackedRefs {
+    FileStamp stamp;
+    bool loaded = false;
+    QHash<QString, QByteArray> refs;    // full ref name -> hex oid
+};
+
+struct RepoRefs {
+    FileStamp dotGitStamp;
+    bool resolved = false;
+    GitDirInfo dirs;
+    CachedFile head;
+    PackedRefs packed;
+    QHash<QString, CachedDir> listings;     // absolute dir -> entries
+    QHash<QString, CachedFile> looseRefs;   // full ref name -> content
+    quint64 generation = 0;                 // set when a listing or packed-refs is re-read
+};
+
+struct RefCache {
+    QMutex mutex;
+    QHash<QString, RepoRefs> repos;
+    quint64 generationCounter = 0;      // process-wide, so values never repeat
+};
+
+Q_GLOBAL_STATIC(RefCache, g_refCache)
+
+// Re-read a small file only when its stamp moved
+const QByteArray& readCached(const QString& path, CachedFile* file)
+{
+    FileStamp stamp;
+    bool exists = statPath(path, &stamp);
+
+    if (file->loaded && exists == file->exists && stamp == file->stamp) {
+        return file->content;
+    }
+
+    file->loaded = true;
+    file->exists = exists;
+    file->stamp = stamp;
+    file->content.clear();
+
+    if (exists) {
+        QFile f(path);
+        if (f.open(QIODevice::ReadOnly)) {
+            file->content = f.readAll().trimmed();
+        }
+    }
+    return file->content;
+}
+
+// Resolve a path read from a git file, relative paths are relative to `base`
+QString resolvePointer(const QString& base, const QByteArray& target)
+{
+    QString path = QString::fromUtf8(target);
+    if (QDir::isRelativePath(path)) {
+        path = QDir(base).filePath(path);
+    }
+    return QDir::cleanPath(path);
+}
+
+RepoRefs& resolveLocked(const QString& workdir)
+{
+    // Returned for non-repositories so discovery does not fill the cache
+    static RepoRefs s_invalid;
+
+    QString dotGit = QDir(workdir).filePath(".git");
+    FileStamp stamp;
+    if (!statPath(dotGit, &stamp)) {
+        g_refCache->repos.remove(workdir);
+        s_invalid = RepoRefs();
+        return s_invalid;
+    }
+
+    RepoRefs& repo = g_refCache->repos[workdir];
+    if (repo.resolved && stamp == repo.dotGitStamp) {
+        return repo;
+    }
+
+    GitDirInfo dirs;
+    QFileInfo info(dotGit);
+    if (info.isDir()) {
+        dirs.gitDir = QDir::cleanPath(dotGit);
+    } else {
+        // Linked worktree or submodule: "gitdir: <path>"
+        CachedFile pointer;
+        QByteArray content = readCached(dotGit, &pointer);
+        if (content.startsWith("gitdir:")) {
+            dirs.gitDir = resolvePointer(workdir, content.mid(7).trimmed());
+            dirs.isLinked = true;
+        }
+    }
+
+    // A dangling pointer (moved or pruned worktree) is not a repository
+    if (dirs.gitDir.isEmpty() || !QFileInfo(dirs.gitDir).isDir()) {
+        g_refCache->repos.remove(workdir);
+        s_invalid = RepoRefs();
+        return s_invalid;
+    }
+
+    // Worktrees keep refs in the main repository
+    CachedFile common;
+    QByteArray content = readCached(QDir(dirs.gitDir).filePath("commondir"), &common);
+    dirs.commonDir = content.isEmpty() ? dirs.gitDir : resolvePointer(dirs.gitDir, content);
+
+    if (dirs.gitDir != repo.dirs.gitDir || dirs.commonDir != repo.dirs.commonDir) {
+        repo = RepoRefs();
+    }
+
+    repo.dirs = dirs;
+    repo.dotGitStamp = stamp;
+    repo.resolved = true;
+    return repo;
+}
+
+void parsePackedRefs(const char* data, qint64 size, QHash<QString, QByteArray>* refs)
+{
+    const char* p = data;
+    const char* end = data + size;
+
+    while (p < end) {
+        const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!eol) eol = end;
+
+        // Header and peeled-tag lines carry no ref name
+        if (p < eol && *p != '#' && *p != '^') {
+            const char* space = static_cast<const char*>(memchr(p, ' ', eol - p));
+            if (space) {
+                const char* nameEnd = eol;
+                if (nameEnd > space && nameEnd[-1] == '\r') nameEnd--;
+                refs->insert(QString::fromUtf8(space + 1, static_cast<int>(nameEnd - space - 1)),
+                             QByteArray(p, static_cast<int>(space - p)));
+            }
+        }
+        p = eol + 1;
+    }
+}
+
+const QHash<QString, QByteArray>& loadPackedLocked(RepoRefs& repo)
+{
+    QString path = QDir(repo.dirs.commonDir).filePath("packed-refs");
+    FileStamp stamp;
+    bool exists = statPath(path, &stamp);
+
+    if (repo.packed.loaded && stamp == repo.packed.stamp) {
+        return repo.packed.refs;
+    }
+
+    repo.packed.loaded = true;
+    repo.packed.stamp = stamp;
+    repo.packed.refs.clear();
+    repo.generation = ++g_refCache->generationCounter;
+
+    if (!exists) {
+        return repo.packed.refs;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return repo.packed.refs;
+    }
+
+    qint64 size = file.size();
+    if (size <= 0) {
+        return repo.packed.refs;
+    }
+
+    // Map instead of read: packed-refs of CI-heavy repos runs into megabytes
+    uchar* data = file.map(0, size);
+    if (data) {
+        parsePackedRefs(reinterpret_cast<const char*>(data), size, &repo.packed.refs);
+        file.unmap(data);
+    } else {
+        QByteArray content = file.readAll();
+        parsePackedRefs(content.constData(), content.size(), &repo.packed.refs);
+    }
+
+    return repo.packed.refs;
+}
+
+// Collect loose ref names below `relDir` (e.g. "refs/heads"), re-listing
+// only directories whose mtime changed. A null `out` only refreshes listings.
+void listLooseLocked(RepoRefs& repo, const QString& relDir, QStringList* out)
+{
+    QString absDir = QDir(repo.dirs.commonDir).filePath(relDir);
+    FileStamp stamp;
+    if (!statPath(absDir, &stamp)) {
+        if (repo.listings.remove(absDir) > 0) {
+            repo.generation = ++g_refCache->generationCounter;
+        }
+        return;
+    }
+
+    CachedDir& listing = repo.listings[absDir];
+    if (listing.stamp != stamp) {
+        QDir dir(absDir);
+        listing.stamp = stamp;
+        listing.files = dir.entryList(QDir::Files | QDir::Hidden, QDir::NoSort);
+        listing.dirs = dir.entryList(QDir::Dirs | QDir::Hidden | QDir::NoDotAndDotDot, QDir::NoSort);
+        repo.generation = ++g_refCache->generationCounter;
+    }
+
+    // Copies: recursion may rehash `listings`
+    const QStringList files = listing.files;
+    const QStringList dirs = listing.dirs;
+
+    if (out) {
+        for (const QString& f : files) {
+            if (!f.endsWith(".lock")) {
+                out->append(relDir + QLatin1Char('/') + f);
+            }
+        }
+    }
+    for (const QString& d : dirs) {
+        listLooseLocked(repo, relDir + QLatin1Char('/') + d, out);
+    }
+}
+
+QStringList listBranchesLocked(RepoRefs& repo, const QString& prefix)
+{
+    QStringList loose;
+    listLooseLocked(repo, prefix, &loose);
+
+    QSet<QString> names;
+    int strip = prefix.length() + 1;
+    for (const QString& ref : loose) {
+        names.insert(ref.mid(strip));
+    }
+
+    const QHash<QString, QByteArray>& packed = loadPackedLocked(repo);
+    QString packedPrefix = prefix + QLatin1Char('/');
+    for (auto it = packed.constBegin(); it != packed.constEnd(); ++it) {
+        if (it.key().startsWith(packedPrefix)) {
+            names.insert(it.key().mid(strip));
+        }
+    }
+
+    return QStringList(names.begin(), names.end());
+}
+
+QByteArray resolveRefLocked(RepoRefs& repo, const QString& refName, int depth)
+{
+    if (depth > 5) {
+        return QByteArray();
+    }
+
+    const QByteArray& loose = readCached(QDir(repo.dirs.commonDir).filePath(refName),
+                                         &repo.looseRefs[refName]);
+    if (!loose.isEmpty()) {
+        if (loose.startsWith("ref: ")) {
+            return resolveRefLocked(repo, QString::fromUtf8(loose.mid(5)), depth + 1);
+        }
+        return loose;
+    }
+
+    return loadPackedLocked(repo).value(refName);
+}
+
+} // namespace
+
+GitDirInfo RefReader::resolveGitDir(const QString& workdir)
+{
+    QMutexLocker locker(&g_refCache->mutex);
+    return resolveLocked(workdir).dirs;
+}
+
+Result<QString, QString> RefReader::currentBranch(const QString& workdir)
+{
+    QMutexLocker locker(&g_refCache->mutex);
+    RepoRefs& repo = resolveLocked(workdir);
+    if (!repo.dirs.isValid()) {
+        return Result<QString, QString>::Err("Invalid repository");
+    }
+
+    // HEAD is per worktree
+    const QByteArray& head = readCached(QDir(repo.dirs.gitDir).filePath("HEAD"), &repo.head);
+    if (head.isEmpty()) {
+        return Result<QString, QString>::Err("Cannot read HEAD");
+    }
+
+    // HEAD format: "ref: refs/heads/branch_name"
+    if (head.startsWith("ref: refs/heads/")) {
+        return Result<QString, QString>::Ok(QString::fromUtf8(head.mid(16)));
+    }
+
+    // Detached HEAD state (raw commit hash)
+    return Result<QString, QString>::Err("Detached HEAD - checkout a branch");
+}
+
+QByteArray RefReader::headOid(const QString& workdir)
+{
+    QMutexLocker locker(&g_refCache->mutex);
+    RepoRefs& repo = resolveLocked(workdir);
+    if (!repo.dirs.isValid()) {
+        return QByteArray();
+    }
+
+    const QByteArray& head = readCached(QDir(repo.dirs.gitDir).filePath("HEAD"), &repo.head);
+    if (head.startsWith("ref: ")) {
+        return resolveRefLocked(repo, QString::fromUtf8(head.mid(5)), 0);
+    }
+    return head;
+}
+
+QByteArray RefReader::resolveRef(const QString& workdir, const QString& refName)
+{
+    QMutexLocker locker(&g_refCache->mutex);
+    RepoRefs& repo = resolveLocked(workdir);
+    if (!repo.dirs.isValid()) {
+        return QByteArray();
+    }
+    return resolveRefLocked(repo, refName, 0);
+}
+
+QStringList RefReader::localBranches(const QString& workdir)
+{
+    QMutexLocker locker(&g_refCache->mutex);
+    RepoRefs& repo = resolveLocked(workdir);
+    if (!repo.dirs.isValid()) {
+        return QStringList();
+    }
+    return listBranchesLocked(repo, "refs/heads");
+}
+
+QStringList RefReader::remoteBranches(const QString& workdir)
+{
+    QMutexLocker locker(&g_refCache->mutex);
+    RepoRefs& repo = resolveLocked(workdir);
+    if (!repo.dirs.isValid()) {
+        return QStringList();
+    }
+
+    QStringList branches = listBranchesLocked(repo, "refs/remotes");
+    // Skip symbolic remote HEADs ("origin/HEAD")
+    branches.erase(std::remove_if(branches.begin(), branches.end(), [](const QString& b) {
+        return b.endsWith("/HEAD");
+    }), branches.end());
+    return branches;
+}
+
+quint64 RefReader::branchesGeneration(const QString& workdir)
+{
+    QMutexLocker locker(&g_refCache->mutex);
+    RepoRefs& repo = resolveLocked(workdir);
+    if (!repo.dirs.isValid()) {
+        return 0;
+    }
+
+    // Stat walk over the cached listings, no names are built
+    listLooseLocked(repo, "refs/heads", nullptr);
+    listLooseLocked(repo, "refs/remotes", nullptr);
+    loadPackedLocked(repo);
+    return repo.generation;
+}
+
+void RefReader::invalidate(const QString& workdir)
+{
+    QMutexLocker locker(&g_refCache->mutex);
+    g_refCache->repos.remove(workdir);
+}
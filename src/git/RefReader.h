@@ -0,0 +1,61 @@
+#ifndef REFREADER_H
+#define REFREADER_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include "core/Result.h"
+
+/**
+ * GitDirInfo - Resolved git directories of a working tree
+ *
+ * gitDir holds the per-worktree files (HEAD, index), commonDir the shared
+ * ones (refs, packed-refs, objects). Both are the same for a plain repo;
+ * they differ for linked worktrees, and submodules point gitDir into the
+ * parent's .git/modules.
+ */
+struct GitDirInfo {
+    QString gitDir;
+    QString commonDir;
+    bool isLinked = false;      // .git is a "gitdir:" file
+
+    bool isValid() const { return !gitDir.isEmpty(); }
+};
+
+/**
+ * RefReader - Lightweight ref reading without libgit2
+ *
+ * Reads HEAD, loose refs and packed-refs straight from disk. packed-refs
+ * is memory-mapped and parsed once; every file and directory read is
+ * cached by mtime, so repeated queries on an unchanged repo cost a few
+ * stat calls. Cheap enough for the UI thread and shared with GitWorker.
+ *
+ * Thread-safe: all state lives in a process-wide cache behind a mutex.
+ */
+class RefReader {
+public:
+    // Resolve .git (directory or "gitdir:" file) and commondir
+    static GitDirInfo resolveGitDir(const QString& workdir);
+
+    // Branch HEAD points to, Err on detached HEAD
+    static Result<QString, QString> currentBranch(const QString& workdir);
+
+    // Hex object id of HEAD, empty if unborn or unreadable
+    static QByteArray headOid(const QString& workdir);
+
+    // Hex object id of a full ref name ("refs/heads/main"), loose before packed
+    static QByteArray resolveRef(const QString& workdir, const QString& refName);
+
+    // Short branch names ("main", "origin/main"), unsorted
+    static QStringList localBranches(const QString& workdir);
+    static QStringList remoteBranches(const QString& workdir);
+
+    // Changes whenever a branch ref may have been added or removed.
+    // Costs a stat per refs directory; 0 for non-repositories.
+    static quint64 branchesGeneration(const QString& workdir);
+
+    // Drop cached state for a repo (e.g. after it was removed)
+    static void invalidate(const QString& workdir);
+};
+
+#endif // REFREADER_H
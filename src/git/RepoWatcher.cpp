@@ -0,0 +1,88 @@
+#include "RepoWatcher.h"
+#include <QSet>
+
+RepoWatcher::RepoWatcher(StatusCache* cache, QObject *parent)
+    : QObject(parent)
+    , m_cache(cache)
+    , m_watcher(new QFileSystemWatcher(this))
+    , m_watchCount(0)
+    , m_budget(DEFAULT_BUDGET)
+{
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &RepoWatcher::onPathChanged);
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &RepoWatcher::onPathChanged);
+}
+
+void RepoWatcher::syncRepo(const QString& repoPath)
+{
+    QStringList wanted = m_cache->snapshotPaths(repoPath);
+    QStringList previous = m_repoPaths.value(repoPath);
+    int available = m_budget - (m_watchCount - previous.size());
+
+    if (wanted.isEmpty() || wanted.size() > available) {
+        // Too big for the budget: leave it to the stat-based check
+        unwatchRepo(repoPath);
+        return;
+    }
+
+    // Watches are dropped by Qt when a file is replaced, so diff against
+    // what the watcher really holds rather than what we added last time
+    QSet<QString> active;
+    for (const QString& p : m_watcher->files()) active.insert(p);
+    for (const QString& p : m_watcher->directories()) active.insert(p);
+
+    QSet<QString> wantedSet(wanted.begin(), wanted.end());
+    QStringList toRemove;
+    for (const QString& p : previous) {
+        if (!wantedSet.contains(p)) {
+            toRemove.append(p);
+            m_pathToRepo.remove(p);
+        }
+    }
+    if (!toRemove.isEmpty()) {
+        m_watcher->removePaths(toRemove);
+    }
+
+    QStringList toAdd;
+    for (const QString& p : wanted) {
+        if (!active.contains(p)) {
+            toAdd.append(p);
+        }
+        m_pathToRepo[p] = repoPath;
+    }
+
+    QStringList failed;
+    if (!toAdd.isEmpty()) {
+        failed = m_watcher->addPaths(toAdd);
+    }
+
+    m_watchCount += wanted.size() - previous.size();
+    m_repoPaths[repoPath] = wanted;
+
+    if (failed.isEmpty()) {
+        m_cache->setWatched(repoPath, wanted);
+    } else {
+        // Out of inotify watches or path vanished: not fully covered
+        m_cache->setWatched(repoPath, QStringList());
+    }
+}
+
+void RepoWatcher::unwatchRepo(const QString& repoPath)
+{
+    QStringList previous = m_repoPaths.take(repoPath);
+    if (!previous.isEmpty()) {
+        m_watcher->removePaths(previous);
+        for (const QString& p : previous) {
+            m_pathToRepo.remove(p);
+        }
+        m_watchCount -= previous.size();
+    }
+    m_cache->setWatched(repoPath, QStringList());
+}
+
+void RepoWatcher::onPathChanged(const QString& path)
+{
+    QString repoPath = m_pathToRepo.value(path);
+    if (!repoPath.isEmpty()) {
+        m_cache->markDirty(repoPath);
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef REPOWATCHER_H
+#define REPOWATCHER_H
+
+#include <QObject>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QStringList>
+#include "git/StatusCache.h"
+
+/**
+ * RepoWatcher - Filesystem watcher feeding StatusCache
+ *
+ * Lives on the UI thread (QFileSystemWatcher needs an event loop). After
+ * GitWorker stores a snapshot, the watcher covers its paths and tells the
+ * cache the repo is watched; any event then marks the repo dirty. Repos
+ * that would exceed the watch budget stay unwatched and fall back to the
+ * stat-based check.
+ */
+class RepoWatcher : public QObject {
+    Q_OBJECT
+
+public:
+    explicit RepoWatcher(StatusCache* cache, QObject *parent = nullptr);
+
+    void setWatchBudget(int budget) { m_budget = budget; }
+    int watchBudget() const { return m_budget; }
+
+public slots:
+    // Cover the current snapshot paths of a repo
+    void syncRepo(const QString& repoPath);
+    void unwatchRepo(const QString& repoPath);
+
+private slots:
+    void onPathChanged(const QString& path);
+
+private:
+    static const int DEFAULT_BUDGET = 8192;
+
+    StatusCache* m_cache;
+    QFileSystemWatcher* m_watcher;
+    QHash<QString, QStringList> m_repoPaths;    // repo -> watched paths
+    QHash<QString, QString> m_pathToRepo;       // watched path -> repo
+    int m_watchCount;
+    int m_budget;
+};
+
+#endif // REPOWATCHER_H
@@ -0,0 +1,275 @@
+#include "StatusCache.h"
+#include "RefReader.h"
+#include <QDir>
+#include <QMutexLocker>
+
+bool StatusCache::lookupNeedsCommit(const QString& repoPath, bool* needsCommit)
+{
+    WorkdirSnapshot snapshot;
+    bool watchedClean = false;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_entries.constFind(repoPath);
+        if (it == m_entries.constEnd() || it->snapshot.gitDir.isEmpty()) {
+            return false;
+        }
+
+        // Implicitly shared, the copy is cheap
+        snapshot = it->snapshot;
+        watchedClean = it->watched && !it->dirty;
+    }
+
+    // Watched and nothing reported: only HEAD is read again, a ref moved
+    // by reset --soft or commit --amend may live outside the watched dirs
+    if (watchedClean && headMatches(repoPath, snapshot)) {
+        *needsCommit = snapshot.needsCommit;
+        return true;
+    }
+
+    // Re-stat outside the lock so the watcher never waits on disk I/O
+    if (!snapshotMatchesDisk(repoPath, snapshot)) {
+        return false;
+    }
+
+    *needsCommit = snapshot.needsCommit;
+    return true;
+}
+
+quint64 StatusCache::generation(const QString& repoPath) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.constFind(repoPath);
+    return it == m_entries.constEnd() ? 0 : it->generation;
+}
+
+void StatusCache::storeSnapshot(const QString& repoPath, const WorkdirSnapshot& snapshot, quint64 generation)
+{
+    QMutexLocker locker(&m_mutex);
+    Entry& entry = m_entries[repoPath];
+    entry.snapshot = snapshot;
+    // The path set may have changed, the watcher has to confirm coverage again
+    entry.watched = false;
+    // A change reported while libgit2 was running keeps the entry dirty
+    entry.dirty = (entry.generation != generation);
+}
+
+bool StatusCache::lookupAheadBehind(const QString& repoPath, AheadBehind* out) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.constFind(repoPath);
+    if (it == m_entries.constEnd() || !it->hasAheadBehind) {
+        return false;
+    }
+    *out = it->aheadBehind;
+    return true;
+}
+
+void StatusCache::storeAheadBehind(const QString& repoPath, const AheadBehind& value)
+{
+    QMutexLocker locker(&m_mutex);
+    Entry& entry = m_entries[repoPath];
+    entry.aheadBehind = value;
+    entry.hasAheadBehind = true;
+}
+
+bool StatusCache::lookupStatus(const QString& repoPath, RepoStatus* out) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.constFind(repoPath);
+    if (it == m_entries.constEnd() || !it->hasStatus) {
+        return false;
+    }
+    *out = it->status;
+    return true;
+}
+
+void StatusCache::storeStatus(const QString& repoPath, const RepoStatus& status)
+{
+    QMutexLocker locker(&m_mutex);
+    Entry& entry = m_entries[repoPath];
+    entry.status = status;
+    entry.hasStatus = true;
+}
+
+bool StatusCache::lookupBranches(const QString& repoPath, const ResultStamp& stamp, QVariant* out) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.constFind(repoPath);
+    if (it == m_entries.constEnd() || !it->branches.isValid() || it->branchesStamp != stamp) {
+        return false;
+    }
+    *out = it->branches;
+    return true;
+}
+
+void StatusCache::storeBranches(const QString& repoPath, const ResultStamp& stamp, const QVariant& data)
+{
+    QMutexLocker locker(&m_mutex);
+    Entry& entry = m_entries[repoPath];
+    entry.branchesStamp = stamp;
+    entry.branches = data;
+}
+
+bool StatusCache::lookupChanges(const QString& repoPath, const ResultStamp& stamp, QVariant* out)
+{
+    WorkdirSnapshot workdir;
+    QVariant changes;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_entries.constFind(repoPath);
+        if (it == m_entries.constEnd() || !it->changes.isValid() || it->changesStamp != stamp) {
+            return false;
+        }
+        workdir = it->changesWorkdir;
+        changes = it->changes;
+    }
+
+    // Same check as the status snapshot, outside the lock
+    if (!snapshotMatchesDisk(repoPath, workdir)) {
+        return false;
+    }
+
+    *out = changes;
+    return true;
+}
+
+void StatusCache::storeChanges(const QString& repoPath, const ResultStamp& stamp,
+                               const WorkdirSnapshot& workdir, const QVariant& data)
+{
+    QMutexLocker locker(&m_mutex);
+    Entry& entry = m_entries[repoPath];
+    entry.changesStamp = stamp;
+    entry.changesWorkdir = workdir;
+    entry.changes = data;
+}
+
+void StatusCache::markDirty(const QString& repoPath)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.find(repoPath);
+    if (it != m_entries.end()) {
+        it->dirty = true;
+        it->generation++;
+    }
+}
+
+void StatusCache::setWatched(const QString& repoPath, const QStringList& coveredPaths)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.find(repoPath);
+    if (it != m_entries.end()) {
+        it->watched = (coveredPaths == pathsOf(repoPath, it->snapshot));
+    }
+}
+
+QStringList StatusCache::snapshotPaths(const QString& repoPath) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.constFind(repoPath);
+    if (it == m_entries.constEnd() || it->snapshot.gitDir.isEmpty()) {
+        return QStringList();
+    }
+    return pathsOf(repoPath, it->snapshot);
+}
+
+void StatusCache::invalidate(const QString& repoPath)
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.remove(repoPath);
+}
+
+void StatusCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+}
+
+QStringList StatusCache::pathsOf(const QString& repoPath, const WorkdirSnapshot& snapshot)
+{
+    // Directories catch create/delete/rename (atomic saves), files catch
+    // in-place writes, the git dir catches index and ref updates
+    QDir root(repoPath);
+    QStringList paths;
+    paths.reserve(snapshot.dirs.size() + snapshot.files.size() + 3);
+    for (auto it = snapshot.dirs.constBegin(); it != snapshot.dirs.constEnd(); ++it) {
+        paths.append(it.key().isEmpty() ? repoPath : root.filePath(it.key()));
+    }
+    for (auto it = snapshot.files.constBegin(); it != snapshot.files.constEnd(); ++it) {
+        paths.append(root.filePath(it.key()));
+    }
+    paths.append(snapshot.gitDir);
+    // Ignore files live outside the watched directories, only existing ones can be watched
+    if (snapshot.excludes.mtimeNs != 0) {
+        paths.append(QDir(snapshot.gitDir).filePath("info/exclude"));
+    }
+    if (snapshot.globalExcludes.mtimeNs != 0) {
+        paths.append(snapshot.excludesFile);
+    }
+    paths.sort();
+    return paths;
+}
+
+bool StatusCache::headMatches(const QString& repoPath, const WorkdirSnapshot& snapshot)
+{
+    return RefReader::headOid(repoPath) == snapshot.headOid &&
+           RefReader::currentBranch(repoPath).valueOr(QString()) == snapshot.headRef;
+}
+
+bool StatusCache::snapshotMatchesDisk(const QString& repoPath, const WorkdirSnapshot& snapshot)
+{
+    // HEAD moved: staged changes are measured against another commit
+    if (!headMatches(repoPath, snapshot)) {
+        return false;
+    }
+
+    FileStamp stamp;
+
+    // Index or excludes changed: staged state or ignore rules may differ
+    if (!statPath(QDir(snapshot.gitDir).filePath("index"), &stamp) || stamp != snapshot.index) {
+        return false;
+    }
+    FileStamp excludes;
+    statPath(QDir(snapshot.gitDir).filePath("info/exclude"), &excludes);
+    if (excludes != snapshot.excludes) {
+        return false;
+    }
+    statPath(snapshot.excludesFile, &excludes);
+    if (excludes != snapshot.globalExcludes) {
+        return false;
+    }
+
+    // A directory mtime moves when an entry is added, removed or renamed,
+    // so unchanged directories never need to be read again
+    QString prefix = repoPath + QLatin1Char('/');
+    for (auto it = snapshot.dirs.constBegin(); it != snapshot.dirs.constEnd(); ++it) {
+        QString path = it.key().isEmpty() ? repoPath : prefix + it.key();
+        if (!statPath(path, &stamp) || stamp != it.value()) {
+            return false;
+        }
+    }
+
+    // Tracked files can change in place without touching their directory
+    for (auto it = snapshot.files.constBegin(); it != snapshot.files.constEnd(); ++it) {
+        if (!statPath(prefix + it.key(), &stamp)) {
+            // Missing now: only a change if it existed at snapshot time
+            if (it.value().mtimeNs != 0) {
+                return false;
+            }
+            continue;
+        }
+        if (stamp != it.value()) {
+            return false;
+        }
+    }
+
+    // Submodules are checked on their own: here only a moved checkout counts
+    for (auto it = snapshot.submodules.constBegin(); it != snapshot.submodules.constEnd(); ++it) {
+        if (RefReader::headOid(prefix + it.key()) != it.value()) {
+            return false;
+        }
+    }
+
+    return true;
+}
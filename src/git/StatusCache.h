@@ -0,0 +1,149 @@
+#ifndef STATUSCACHE_H
+#define STATUSCACHE_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QByteArray>
+#include <QMutex>
+#include <QVariant>
+#include "core/FileStat.h"
+#include "git/GitStatus.h"
+
+/**
+ * WorkdirSnapshot - Filesystem state of a repository at its last full status check
+ *
+ * Holds the stat data of every tracked file, the mtimes of every directory
+ * the status walk enters (tracked, untracked, empty or holding only ignored
+ * files), HEAD and the stamps of the git files that influence status.
+ */
+struct WorkdirSnapshot {
+    QString gitDir;
+    QString headRef;                        // branch HEAD points to, empty when detached
+    QByteArray headOid;                     // commit staged changes are compared with
+    QHash<QString, FileStamp> files;        // relative path -> stat data
+    QHash<QString, FileStamp> dirs;         // relative dir ("" = workdir root) -> stat data
+    FileStamp index;                        // <gitdir>/index
+    FileStamp excludes;                     // <gitdir>/info/exclude
+    QString excludesFile;                   // core.excludesFile or its XDG default
+    FileStamp globalExcludes;               // stat data of excludesFile
+    QHash<QString, QByteArray> submodules;  // relative path -> checked-out commit (hex)
+    bool needsCommit = false;
+};
+
+/**
+ * AheadBehind - Memoized ahead/behind counts for a (local, upstream) commit pair
+ *
+ * Object ids are kept as raw bytes so this header stays free of libgit2.
+ */
+struct AheadBehind {
+    QByteArray localOid;
+    QByteArray upstreamOid;
+    int ahead = 0;
+    int behind = 0;
+};
+
+/**
+ * ResultStamp - Cheap identity of the repository state a read-only result was built on
+ *
+ * HEAD (symbolic target and object id), the branch refs generation from
+ * RefReader and the index stat data. None of them needs libgit2.
+ */
+struct ResultStamp {
+    QString headRef;
+    QByteArray headOid;
+    quint64 refsGeneration = 0;
+    FileStamp index;
+
+    bool operator==(const ResultStamp& other) const {
+        return headRef == other.headRef && headOid == other.headOid &&
+               refsGeneration == other.refsGeneration && index == other.index;
+    }
+    bool operator!=(const ResultStamp& other) const { return !(*this == other); }
+};
+
+/**
+ * StatusCache - Per-repository workdir snapshots shared by GitWorker and RepoWatcher
+ *
+ * A status check first asks the cache whether the last snapshot still
+ * matches the disk. If a RepoWatcher covers the repository and reported
+ * nothing since the last check, the answer is immediate. Otherwise only the
+ * recorded directories and tracked files are re-stat'ed; libgit2 is only
+ * called when something actually moved.
+ *
+ * The last ahead/behind result of each repo lives next to its snapshot, so
+ * a sweep over unchanged repos costs neither a status nor a graph walk.
+ *
+ * GetBranches and GetChanges results are kept with the ResultStamp they
+ * were built on (changes also with a workdir snapshot of their own), so the
+ * refresh queued after every operation is answered from memory when
+ * nothing moved.
+ *
+ * Thread-safe: the watcher marks repos dirty from the UI thread while
+ * GitWorker reads and stores snapshots from its own thread.
+ */
+class StatusCache {
+public:
+    StatusCache() = default;
+
+    // Returns true and fills needsCommit if the snapshot is still valid
+    bool lookupNeedsCommit(const QString& repoPath, bool* needsCommit);
+
+    // Change counter, read before a full status so events during it are not lost
+    quint64 generation(const QString& repoPath) const;
+
+    // Store a snapshot taken right after a full libgit2 status
+    void storeSnapshot(const QString& repoPath, const WorkdirSnapshot& snapshot, quint64 generation);
+
+    // Last ahead/behind computed for the repo (any commit pair)
+    bool lookupAheadBehind(const QString& repoPath, AheadBehind* out) const;
+    void storeAheadBehind(const QString& repoPath, const AheadBehind& value);
+
+    // Last full status reported for the repo, used to pick bulk-task targets
+    bool lookupStatus(const QString& repoPath, RepoStatus* out) const;
+    void storeStatus(const QString& repoPath, const RepoStatus& status);
+
+    // Read-only task results, returned only while `stamp` (and for changes
+    // the workdir) still matches
+    bool lookupBranches(const QString& repoPath, const ResultStamp& stamp, QVariant* out) const;
+    void storeBranches(const QString& repoPath, const ResultStamp& stamp, const QVariant& data);
+    bool lookupChanges(const QString& repoPath, const ResultStamp& stamp, QVariant* out);
+    void storeChanges(const QString& repoPath, const ResultStamp& stamp,
+                      const WorkdirSnapshot& workdir, const QVariant& data);
+
+    // Watcher feed
+    void markDirty(const QString& repoPath);
+    void setWatched(const QString& repoPath, const QStringList& coveredPaths);
+
+    // Absolute paths the watcher must cover for the repo to count as watched
+    QStringList snapshotPaths(const QString& repoPath) const;
+
+    void invalidate(const QString& repoPath);
+    void clear();
+
+private:
+    struct Entry {
+        WorkdirSnapshot snapshot;
+        AheadBehind aheadBehind;
+        bool hasAheadBehind = false;
+        RepoStatus status;
+        bool hasStatus = false;
+        ResultStamp branchesStamp;
+        QVariant branches;
+        ResultStamp changesStamp;
+        WorkdirSnapshot changesWorkdir;
+        QVariant changes;
+        bool watched = false;       // watcher covers every snapshot path
+        bool dirty = true;          // watcher reported a change since last store
+        quint64 generation = 0;     // bumped on every markDirty
+    };
+
+    mutable QMutex m_mutex;
+    QHash<QString, Entry> m_entries;
+
+    static bool headMatches(const QString& repoPath, const WorkdirSnapshot& snapshot);
+    static bool snapshotMatchesDisk(const QString& repoPath, const WorkdirSnapshot& snapshot);
+    static QStringList pathsOf(const QString& repoPath, const WorkdirSnapshot& snapshot);
+};
+
+#endif // STATUSCACHE_H
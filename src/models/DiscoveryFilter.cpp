@@ -0,0 +1,50 @@
+#include "DiscoveryFilter.h"
+
+// One alternation of anchored globs, empty pattern if there are none
+static QRegularExpression compileGlobs(const QStringList& globs)
+{
+    if (globs.isEmpty()) {
+        return QRegularExpression();
+    }
+    QStringList parts;
+    for (const QString& glob : globs) {
+        // '*' stops at '/', so path globs match segment by segment
+        parts.append(QRegularExpression::wildcardToRegularExpression(glob));
+    }
+    QRegularExpression re("(?:" + parts.join(")|(?:") + ")");
+    re.optimize();
+    return re;
+}
+
+DiscoveryFilter::DiscoveryFilter(const DiscoveryOptions& options)
+    : m_options(options)
+{
+    QStringList nameGlobs;
+    QStringList pathGlobs;
+    for (const QString& pattern : options.exclude) {
+        QString glob = pattern.trimmed();
+        if (glob.isEmpty()) continue;
+
+        if (glob.contains(QLatin1Char('/'))) {
+            pathGlobs.append(glob);
+        } else if (glob.contains(QLatin1Char('*')) || glob.contains(QLatin1Char('?')) ||
+                   glob.contains(QLatin1Char('['))) {
+            nameGlobs.append(glob);
+        } else {
+            m_names.insert(glob);
+        }
+    }
+    m_nameGlobs = compileGlobs(nameGlobs);
+    m_pathGlobs = compileGlobs(pathGlobs);
+}
+
+bool DiscoveryFilter::excluded(const QString& name, const QString& relativePath) const
+{
+    if (m_names.contains(name)) {
+        return true;
+    }
+    if (!m_nameGlobs.pattern().isEmpty() && m_nameGlobs.match(name).hasMatch()) {
+        return true;
+    }
+    return !m_pathGlobs.pattern().isEmpty() && m_pathGlobs.match(relativePath).hasMatch();
+}
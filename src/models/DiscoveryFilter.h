@@ -0,0 +1,59 @@
+#ifndef DISCOVERYFILTER_H
+#define DISCOVERYFILTER_H
+
+#include <QString>
+#include <QStringList>
+#include <QSet>
+#include <QRegularExpression>
+
+/**
+ * DiscoveryOptions - How far and where repository discovery may walk
+ */
+struct DiscoveryOptions {
+    int maxDepth = 0;               // Directory levels below each root (0 = unlimited)
+    QStringList exclude = defaultExclude();
+    bool stopAtRepos = true;        // Do not look for repositories inside repositories
+    bool submodules = false;        // Still descend into submodules when stopping at a repo
+    bool followSymlinks = true;     // Follow symlinked directories, loops are detected
+
+    static QStringList defaultExclude() {
+        return {".*", "node_modules", "__pycache__", "venv", "build", "target", "dist"};
+    }
+
+    bool operator==(const DiscoveryOptions& other) const {
+        return maxDepth == other.maxDepth && exclude == other.exclude &&
+               stopAtRepos == other.stopAtRepos && submodules == other.submodules &&
+               followSymlinks == other.followSymlinks;
+    }
+    bool operator!=(const DiscoveryOptions& other) const { return !(*this == other); }
+};
+
+/**
+ * DiscoveryFilter - DiscoveryOptions compiled for the directory walk
+ *
+ * Exclusion globs are split once: literal names go into a set, wildcard
+ * names into a single alternation, and patterns containing '/' into a
+ * second one matched against the path relative to the scanned root.
+ */
+class DiscoveryFilter {
+public:
+    explicit DiscoveryFilter(const DiscoveryOptions& options = DiscoveryOptions());
+
+    const DiscoveryOptions& options() const { return m_options; }
+
+    // Directory named name, at relativePath below its root, is not walked
+    bool excluded(const QString& name, const QString& relativePath) const;
+
+    // A directory at this depth (root = 0) may be walked
+    bool depthAllowed(int depth) const {
+        return m_options.maxDepth <= 0 || depth <= m_options.maxDepth;
+    }
+
+private:
+    DiscoveryOptions m_options;
+    QSet<QString> m_names;
+    QRegularExpression m_nameGlobs;
+    QRegularExpression m_pathGlobs;
+};
+
+#endif // DISCOVERYFILTER_H
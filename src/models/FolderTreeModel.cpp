@@ -1,213 +1,695 @@
 #include "FolderTreeModel.h"
 #include <QDir>
 #include <QDirIterator>
+#include <QFile>
 #include <QFileInfo>
 #include <QIcon>
 #include <QPixmap>
+#include <QSet>
+#include <algorithm>
 #include "icons/icons.h"
+#include "git/RefReader.h"
+#include "core/FileStat.h"
+#include "core/StatEngine.h"
 
-// FolderItem implementation
-FolderItem::FolderItem(const QString& name)
-    : QStandardItem(name)
-    , depth(0)
-    , isRepo(false)
-    , needsPull(false)
-    , needsPush(false)
-    , needsCommit(false)
-    , statusError(false)
-    , statusChecked(false)
+// Decoration of a node, derived from its depth and status bits. A repository
+// also shows what its submodules need.
+static FolderTreeModel::IconKind iconKind(FolderNode node)
 {
-    setEditable(false);
+    node.flags |= node.childFlags;
+    if (node.isRepo()) {
+        if (node.statusError()) return FolderTreeModel::IconError;
+        if (node.needsPull()) return FolderTreeModel::IconPull;
+        if (node.needsPush()) return FolderTreeModel::IconPush;
+        if (node.needsCommit()) return FolderTreeModel::IconCommit;
+        if (node.statusChecked()) return FolderTreeModel::IconClean;
+        // Default - not checked yet
+        return FolderTreeModel::IconUnchecked;
+    }
+    // Root drive or folder
+    return node.depth == 0 ? FolderTreeModel::IconDrive : FolderTreeModel::IconFolder;
 }
 
-void FolderItem::updateIcon()
+FolderTreeModel::FolderTreeModel(QObject *parent)
+    : QAbstractItemModel(parent)
 {
-    QPixmap pixmap;
-
-    if (isRepo) {
-        if (statusError) {
-            pixmap.loadFromData(icon_exclamation_red_png, icon_exclamation_red_png_len, "PNG");
-        } else if (needsPull) {
-            pixmap.loadFromData(icon_drive_download_png, icon_drive_download_png_len, "PNG");
-        } else if (needsPush) {
-            pixmap.loadFromData(icon_drive_upload_png, icon_drive_upload_png_len, "PNG");
-        } else if (needsCommit) {
-            pixmap.loadFromData(icon_disk_plus_png, icon_disk_plus_png_len, "PNG");
-        } else if (statusChecked) {
-            pixmap.loadFromData(icon_document_png, icon_document_png_len, "PNG");
-        } else {
-            // Default - not checked yet
-            pixmap.loadFromData(icon_arrow_circle_315_png, icon_arrow_circle_315_png_len, "PNG");
-        }
-    } else if (depth == 0) {
-        // Root drive
-        pixmap.loadFromData(icon_drive_png, icon_drive_png_len, "PNG");
-    } else {
-        // Folder
-        pixmap.loadFromData(icon_folder_horizontal_png, icon_folder_horizontal_png_len, "PNG");
-    }
-
-    setIcon(QIcon(pixmap));
+    reset();
 }
 
-// FolderTreeModel implementation
-FolderTreeModel::FolderTreeModel(QObject *parent)
-    : QStandardItemModel(parent)
+void FolderTreeModel::reset()
 {
-    setColumnCount(1);
+    m_nodes.clear();
+    m_children.clear();
+    m_repos.clear();
+    m_freeNodes.clear();
+    m_freeRepos.clear();
+    m_staleChildren = 0;
+    m_paths.clear();
+    m_pathToNode.clear();
+    m_dirs.clear();
+
+    // Invisible root
+    addNode(PathInterner::None, 0);
 }
 
 void FolderTreeModel::clearAll()
 {
-    clear();
-    m_pathToItem.clear();
+    beginResetModel();
+    reset();
+    endResetModel();
 }
 
 void FolderTreeModel::scanPaths(const QStringList& paths)
 {
-    clearAll();
+    beginResetModel();
+    reset();
+
+    QVector<ScanEntry> roots = walkRoots(paths);
+    QVector<int> rootNodes;
+    for (const ScanEntry& root : roots) {
+        rootNodes.append(buildSubtree(root));
+    }
+    setChildren(0, rootNodes);
+
+    endResetModel();
+    emit scanComplete();
+}
+
+void FolderTreeModel::rescan(const QStringList& paths)
+{
+    // Rows are inserted and removed in place, so views keep their
+    // expansion state and untouched repos keep their status
+    syncChildren(0, walkRoots(paths));
+    emit scanComplete();
+}
+
+void FolderTreeModel::setDiscoveryOptions(const DiscoveryOptions& options)
+{
+    if (options == m_filter.options()) {
+        return;
+    }
+    m_filter = DiscoveryFilter(options);
+    // Recorded listings were filtered with the old options
+    m_dirs.clear();
+}
 
+QVector<FolderTreeModel::ScanEntry> FolderTreeModel::walkRoots(const QStringList& paths)
+{
+    QVector<ScanEntry> roots;
+    m_visited.clear();
     for (const QString& rootPath : paths) {
-        QDir rootDir(rootPath);
-        if (!rootDir.exists()) {
+        // Stored without trailing separator so the last segment is the folder name
+        QString cleanRoot = QDir::cleanPath(rootPath);
+        ScanEntry root;
+        if (!QDir(cleanRoot).exists()) {
             continue;
         }
+        // Roots are shown even without repositories below them
+        m_walkRootLength = cleanRoot.size();
+        walkDirectory(cleanRoot, m_paths.internPath(cleanRoot), 0, &root);
+        if (root.path != PathInterner::None) {
+            roots.append(std::move(root));
+        }
+    }
+    return roots;
+}
+
+// Submodule paths declared in a repository's .gitmodules
+static QStringList submodulePaths(const QString& repoPath)
+{
+    QStringList paths;
+    QFile file(repoPath + QLatin1String("/.gitmodules"));
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return paths;
+    }
+    while (!file.atEnd()) {
+        QString line = QString::fromUtf8(file.readLine()).trimmed();
+        int eq = line.indexOf(QLatin1Char('='));
+        if (eq > 0 && line.left(eq).trimmed() == QLatin1String("path")) {
+            QString path = QDir::cleanPath(line.mid(eq + 1).trimmed());
+            if (!path.isEmpty() && !path.startsWith(QLatin1String(".."))) {
+                paths.append(path);
+            }
+        }
+    }
+    return paths;
+}
+
+bool FolderTreeModel::walkDirectory(const QString& path, PathInterner::Id id, int depth, ScanEntry* out,
+                                    const StatResult* known)
+{
+    FileStamp stamp;
+    FileId fileId;
+    bool exists = known ? known->error == 0 : statPath(path, &stamp, &fileId);
+    if (!exists) {
+        m_dirs.remove(id);
+        return false;
+    }
+    if (known) {
+        stamp = known->stamp();
+        fileId = known->id();
+    }
+
+    // Symlink loops and directories reachable twice are walked once
+    if (m_visited.contains(fileId)) {
+        return false;
+    }
+    m_visited.insert(fileId);
+
+    out->path = id;
+    out->depth = depth;
 
-        // Create root item
-        FolderItem* rootItem = new FolderItem(rootDir.dirName());
-        rootItem->osPath = rootPath;
-        rootItem->relativePath = rootDir.dirName();
-        rootItem->depth = 0;
-        rootItem->isRepo = QFileInfo::exists(rootDir.filePath(".git"));
+    // An unchanged mtime means the same entries: neither .git nor any
+    // subdirectory was added, removed or renamed here
+    auto it = m_dirs.find(id);
+    if (it == m_dirs.end() || it->mtimeNs != stamp.mtimeNs) {
+        DirRecord record;
+        record.mtimeNs = stamp.mtimeNs;
 
-        m_pathToItem[rootPath] = rootItem;
-        invisibleRootItem()->appendRow(rootItem);
+        // Resolve .git once here (directory or "gitdir:" file) so workers can
+        // open the repository without searching
+        out->git = RefReader::resolveGitDir(path);
+        record.repo = out->git.isValid();
 
-        // Scan subdirectories
-        if (!rootItem->isRepo) {
-            scanDirectory(rootPath, rootItem, 1);
+        const DiscoveryOptions& options = m_filter.options();
+        if (record.repo && options.stopAtRepos) {
+            // Only submodules lead further down, wherever they are nested
+            if (options.submodules) {
+                for (const QString& sub : submodulePaths(path)) {
+                    PathInterner::Id subId = id;
+                    for (const QString& part : sub.split(QLatin1Char('/'))) {
+                        subId = m_paths.intern(subId, part);
+                    }
+                    record.subdirs.append(subId);
+                }
+            }
+        } else {
+            QDir::Filters filters = QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden;
+            if (!options.followSymlinks) {
+                filters |= QDir::NoSymLinks;
+            }
+            const QStringList entries = QDir(path).entryList(filters, QDir::Name);
+            QString relativeDir = path.mid(m_walkRootLength + 1);
+            for (const QString& entry : entries) {
+                if (entry == QLatin1String(".git")) continue;
+                QString relative = relativeDir.isEmpty() ? entry : relativeDir + QLatin1Char('/') + entry;
+                if (m_filter.excluded(entry, relative)) continue;
+                record.subdirs.append(m_paths.intern(id, entry));
+            }
         }
+        it = m_dirs.insert(id, record);
+    }
 
-        // Update icon after scanning (to reflect if it has children)
-        rootItem->updateIcon();
+    out->repo = it->repo;
+    if (!m_filter.depthAllowed(depth + 1)) {
+        return out->repo;
     }
 
-    emit scanComplete();
+    // Copy: the walk below inserts into m_dirs
+    const QVector<PathInterner::Id> subdirs = it->subdirs;
+    QStringList subPaths;
+    QVector<QByteArray> encoded;
+    QVector<const char*> names;
+    subPaths.reserve(subdirs.size());
+    encoded.reserve(subdirs.size());
+    names.reserve(subdirs.size());
+    for (PathInterner::Id sub : subdirs) {
+        // Submodules may sit several levels below their repository
+        subPaths.append(m_paths.parent(sub) == id
+            ? path + QLatin1Char('/') + m_paths.segment(sub)
+            : m_paths.path(sub));
+        encoded.append(QFile::encodeName(subPaths.last()));
+        names.append(encoded.last().constData());
+    }
+
+    // Siblings are stated in one batch so their latencies overlap; on an
+    // unchanged tree these stats are most of the walk
+    QVector<StatResult> stats(subdirs.size());
+    StatEngine::instance().stat(StatEngine::CurrentDir, names.constData(), names.size(),
+                                stats.data());
+
+    for (int i = 0; i < subdirs.size(); ++i) {
+        ScanEntry child;
+        if (walkDirectory(subPaths[i], subdirs[i], depth + 1, &child, &stats[i])) {
+            out->children.append(std::move(child));
+        }
+    }
+    return out->repo || !out->children.isEmpty();
+}
+
+int FolderTreeModel::buildSubtree(const ScanEntry& entry)
+{
+    int node = addNode(entry.path, entry.depth);
+    if (entry.repo) {
+        // Directory unchanged since an earlier walk: resolve again
+        GitDirInfo git = entry.git.isValid() ? entry.git : RefReader::resolveGitDir(m_paths.path(entry.path));
+        m_nodes[node].flags |= FolderNode::IsRepo;
+        if (m_freeRepos.isEmpty()) {
+            m_nodes[node].repo = m_repos.size();
+            m_repos.append({git.gitDir, git.commonDir});
+        } else {
+            m_nodes[node].repo = m_freeRepos.takeLast();
+            m_repos[m_nodes[node].repo] = {git.gitDir, git.commonDir};
+        }
+    }
+    m_pathToNode[entry.path] = node;
+
+    QVector<int> children;
+    for (const ScanEntry& child : entry.children) {
+        children.append(buildSubtree(child));
+    }
+    setChildren(node, children);
+    return node;
 }
 
-bool FolderTreeModel::scanDirectory(const QString& path, FolderItem* parent, int depth)
+void FolderTreeModel::dropSubtree(int node)
 {
-    QDir dir(path);
-    QStringList entries = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
-    bool hasRepos = false;
+    const FolderNode& entry = m_nodes[node];
+    for (int i = 0; i < entry.childCount; ++i) {
+        dropSubtree(m_children[entry.childStart + i]);
+    }
+    if (m_pathToNode.value(entry.path, -1) == node) {
+        m_pathToNode.remove(entry.path);
+    }
+    if (entry.repo >= 0) {
+        m_repos[entry.repo] = RepoDirs();
+        m_freeRepos.append(entry.repo);
+    }
 
-    for (const QString& entry : entries) {
-        // Skip hidden directories and common non-repo directories
-        if (entry.startsWith(".") || entry == "node_modules" ||
-            entry == "__pycache__" || entry == "venv" || entry == ".venv" ||
-            entry == "build" || entry == "target" || entry == "dist") {
+    // Slot and id are handed out again by later rescans
+    m_staleChildren += entry.childCount;
+    m_nodes[node] = FolderNode();
+    m_freeNodes.append(node);
+}
+
+int FolderTreeModel::addNode(PathInterner::Id path, int depth)
+{
+    FolderNode node;
+    node.path = path;
+    node.depth = quint16(depth);
+    if (!m_freeNodes.isEmpty()) {
+        int id = m_freeNodes.takeLast();
+        m_nodes[id] = node;
+        return id;
+    }
+    m_nodes.append(node);
+    return m_nodes.size() - 1;
+}
+
+void FolderTreeModel::setChildren(int parent, const QVector<int>& children)
+{
+    FolderNode& node = m_nodes[parent];
+    int count = children.size();
+    if (node.childCount == 0) {
+        node.childStart = m_children.size();
+    }
+
+    if (count <= node.childCount) {
+        // Fewer children: the old range holds them, the tail goes stale
+        m_staleChildren += node.childCount - count;
+    } else if (node.childStart + node.childCount == m_children.size()) {
+        // Last range in the table: grow it in place
+        m_children.resize(node.childStart + count);
+    } else {
+        m_staleChildren += node.childCount;
+        node.childStart = m_children.size();
+        m_children.resize(node.childStart + count);
+    }
+    node.childCount = count;
+    std::copy(children.cbegin(), children.cend(), m_children.begin() + node.childStart);
+    for (int row = 0; row < count; ++row) {
+        m_nodes[children[row]].parent = parent;
+        m_nodes[children[row]].row = row;
+    }
+
+    if (m_staleChildren > 1024 && m_staleChildren > m_children.size() / 2) {
+        compactChildren();
+    }
+}
+
+void FolderTreeModel::compactChildren()
+{
+    // Dropped nodes have no children, so every range copied is a live one
+    // (or belongs to a subtree still being built)
+    QVector<int> packed;
+    packed.reserve(m_children.size() - m_staleChildren);
+    for (FolderNode& node : m_nodes) {
+        int start = packed.size();
+        packed.append(m_children.mid(node.childStart, node.childCount));
+        node.childStart = start;
+    }
+    m_children = std::move(packed);
+    m_staleChildren = 0;
+}
+
+void FolderTreeModel::syncChildren(int node, const QVector<ScanEntry>& wanted)
+{
+    QModelIndex parentIndex = indexOf(node);
+
+    QHash<PathInterner::Id, int> wantedAt;
+    for (int i = 0; i < wanted.size(); ++i) {
+        wantedAt.insert(wanted[i].path, i);
+    }
+
+    // Children kept as they are: still wanted, same kind, and in walk order
+    // (a reordered one is removed and inserted again at its new row)
+    QVector<int> current = m_children.mid(m_nodes[node].childStart, m_nodes[node].childCount);
+    QSet<int> kept;
+    int lastAt = -1;
+    for (int child : current) {
+        int at = wantedAt.value(m_nodes[child].path, -1);
+        if (at > lastAt && wanted[at].repo == m_nodes[child].isRepo()) {
+            kept.insert(child);
+            lastAt = at;
+        }
+    }
+    auto keep = [&](int child) { return kept.contains(child); };
+
+    // Remove vanished entries, one contiguous run at a time from the end
+    for (int row = current.size() - 1; row >= 0; --row) {
+        if (keep(current[row])) continue;
+        int last = row;
+        while (row > 0 && !keep(current[row - 1])) --row;
+
+        beginRemoveRows(parentIndex, row, last);
+        for (int r = row; r <= last; ++r) {
+            dropSubtree(current[r]);
+        }
+        current.remove(row, last - row + 1);
+        setChildren(node, current);
+        endRemoveRows();
+    }
+
+    // What is left is in walk order too: insert new runs where they belong
+    QVector<bool> existing(wanted.size(), false);
+    int row = 0;
+    for (int i = 0; i < wanted.size(); ++i) {
+        if (row < current.size() && m_nodes[current[row]].path == wanted[i].path) {
+            existing[i] = true;
+            ++row;
             continue;
         }
+        int first = i;
+        while (i + 1 < wanted.size() &&
+               !(row < current.size() && m_nodes[current[row]].path == wanted[i + 1].path)) {
+            ++i;
+        }
 
-        QString fullPath = dir.filePath(entry);
-        bool isGitRepo = QFileInfo::exists(QDir(fullPath).filePath(".git"));
+        beginInsertRows(parentIndex, row, row + i - first);
+        QVector<int> added;
+        for (int k = first; k <= i; ++k) {
+            added.append(buildSubtree(wanted[k]));
+        }
+        for (int k = 0; k < added.size(); ++k) {
+            current.insert(row + k, added[k]);
+        }
+        setChildren(node, current);
+        endInsertRows();
+        row += added.size();
+    }
 
-        if (isGitRepo) {
-            // Add repo directly
-            FolderItem* item = new FolderItem(entry);
-            item->osPath = fullPath;
-            item->relativePath = entry;
-            item->depth = depth;
-            item->isRepo = true;
-            item->updateIcon();
+    // Submodules added or removed change what a repository row summarises
+    if (node > 0 && m_nodes[node].isRepo() && refreshChildFlags(node)) {
+        QVector<int> changed{node};
+        propagateUp(node, &changed);
+        emitStatusChanged(changed);
+    }
 
-            m_pathToItem[fullPath] = item;
-            parent->appendRow(item);
-            hasRepos = true;
-        } else {
-            // Create temporary item to scan children
-            FolderItem* item = new FolderItem(entry);
-            item->osPath = fullPath;
-            item->relativePath = entry;
-            item->depth = depth;
-            item->isRepo = false;
-
-            // Recursively scan - only add if contains repos
-            bool childHasRepos = scanDirectory(fullPath, item, depth + 1);
-
-            if (childHasRepos) {
-                item->updateIcon();
-                m_pathToItem[fullPath] = item;
-                parent->appendRow(item);
-                hasRepos = true;
-            } else {
-                // No repos found, discard this folder
-                delete item;
-            }
+    // Entries that were already there may have changed further down, and a
+    // kept repository's .git file may point to another git dir by now
+    row = 0;
+    for (int i = 0; i < wanted.size(); ++i, ++row) {
+        if (!existing[i]) continue;
+        int child = current[row];
+        if (m_nodes[child].isRepo()) {
+            GitDirInfo git = wanted[i].git.isValid()
+                ? wanted[i].git : RefReader::resolveGitDir(m_paths.path(wanted[i].path));
+            m_repos[m_nodes[child].repo] = {git.gitDir, git.commonDir};
         }
+        syncChildren(child, wanted[i].children);
     }
+}
 
-    return hasRepos;
+QModelIndex FolderTreeModel::index(int row, int column, const QModelIndex& parent) const
+{
+    const FolderNode& node = m_nodes[parent.isValid() ? int(parent.internalId()) : 0];
+    if (column != 0 || row < 0 || row >= node.childCount) {
+        return QModelIndex();
+    }
+    return createIndex(row, 0, quintptr(m_children[node.childStart + row]));
 }
 
-FolderItem* FolderTreeModel::getItemAt(const QModelIndex& index) const
+QModelIndex FolderTreeModel::parent(const QModelIndex& child) const
 {
-    QStandardItem* item = itemFromIndex(index);
-    return dynamic_cast<FolderItem*>(item);
+    if (!child.isValid()) {
+        return QModelIndex();
+    }
+    return indexOf(m_nodes[int(child.internalId())].parent);
 }
 
-FolderItem* FolderTreeModel::findByPath(const QString& path) const
+int FolderTreeModel::rowCount(const QModelIndex& parent) const
 {
-    return m_pathToItem.value(path, nullptr);
+    if (parent.column() > 0) {
+        return 0;
+    }
+    return m_nodes[parent.isValid() ? int(parent.internalId()) : 0].childCount;
 }
 
-void FolderTreeModel::updateRepoStatus(const QString& path, const RepoStatus& status)
+int FolderTreeModel::columnCount(const QModelIndex& parent) const
 {
-    FolderItem* item = findByPath(path);
-    if (!item || !item->isRepo) {
-        return;
+    Q_UNUSED(parent);
+    return 1;
+}
+
+QVariant FolderTreeModel::data(const QModelIndex& index, int role) const
+{
+    int id = nodeAt(index);
+    if (id < 0) {
+        return QVariant();
     }
 
-    item->needsPull = status.needsPull;
-    item->needsPush = status.needsPush;
-    item->needsCommit = status.needsCommit;
-    item->statusError = status.hasError;
-    item->statusChecked = true;
-    item->updateIcon();
+    switch (role) {
+    case Qt::DisplayRole:
+        return nodeName(id);
+    case Qt::DecorationRole:
+        return icon(iconKind(m_nodes[id]));
+    default:
+        return QVariant();
+    }
 }
 
-QStringList FolderTreeModel::getAllRepoPaths() const
+Qt::ItemFlags FolderTreeModel::flags(const QModelIndex& index) const
 {
-    QStringList paths;
-    for (auto it = m_pathToItem.constBegin(); it != m_pathToItem.constEnd(); ++it) {
-        if (it.value()->isRepo) {
-            paths.append(it.key());
+    if (!index.isValid()) {
+        return Qt::NoItemFlags;
+    }
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+QIcon FolderTreeModel::icon(IconKind kind) const
+{
+    // One shared icon per kind instead of one per node
+    QIcon& cached = m_icons[kind];
+    if (!cached.isNull()) {
+        return cached;
+    }
+
+    QPixmap pixmap;
+    switch (kind) {
+    case IconError:
+        pixmap.loadFromData(icon_exclamation_red_png, icon_exclamation_red_png_len, "PNG");
+        break;
+    case IconPull:
+        pixmap.loadFromData(icon_drive_download_png, icon_drive_download_png_len, "PNG");
+        break;
+    case IconPush:
+        pixmap.loadFromData(icon_drive_upload_png, icon_drive_upload_png_len, "PNG");
+        break;
+    case IconCommit:
+        pixmap.loadFromData(icon_disk_plus_png, icon_disk_plus_png_len, "PNG");
+        break;
+    case IconClean:
+        pixmap.loadFromData(icon_document_png, icon_document_png_len, "PNG");
+        break;
+    case IconUnchecked:
+        pixmap.loadFromData(icon_arrow_circle_315_png, icon_arrow_circle_315_png_len, "PNG");
+        break;
+    case IconDrive:
+        pixmap.loadFromData(icon_drive_png, icon_drive_png_len, "PNG");
+        break;
+    case IconFolder:
+    case IconCount:
+        pixmap.loadFromData(icon_folder_horizontal_png, icon_folder_horizontal_png_len, "PNG");
+        break;
+    }
+
+    cached = QIcon(pixmap);
+    return cached;
+}
+
+int FolderTreeModel::nodeAt(const QModelIndex& index) const
+{
+    if (!index.isValid() || index.model() != this) {
+        return -1;
+    }
+    return int(index.internalId());
+}
+
+QModelIndex FolderTreeModel::indexOf(int node) const
+{
+    if (node <= 0 || node >= m_nodes.size()) {
+        return QModelIndex();
+    }
+    return createIndex(m_nodes[node].row, 0, quintptr(node));
+}
+
+int FolderTreeModel::findByPath(const QString& path) const
+{
+    PathInterner::Id id = m_paths.findPath(path);
+    return id == PathInterner::None ? -1 : m_pathToNode.value(id, -1);
+}
+
+QString FolderTreeModel::gitDir(int id) const
+{
+    int repo = m_nodes[id].repo;
+    return repo < 0 ? QString() : m_repos[repo].gitDir;
+}
+
+QString FolderTreeModel::commonDir(int id) const
+{
+    int repo = m_nodes[id].repo;
+    return repo < 0 ? QString() : m_repos[repo].commonDir;
+}
+
+bool FolderTreeModel::applyStatus(int node, const RepoStatus& status)
+{
+    if (node < 0 || !m_nodes[node].isRepo()) {
+        return false;
+    }
+
+    quint8 bits = FolderNode::StatusChecked;
+    if (status.needsPull) bits |= FolderNode::NeedsPull;
+    if (status.needsPush) bits |= FolderNode::NeedsPush;
+    if (status.needsCommit) bits |= FolderNode::NeedsCommit;
+    if (status.hasError) bits |= FolderNode::StatusError;
+
+    // Same state as before: nothing to repaint
+    FolderNode& entry = m_nodes[node];
+    if ((entry.flags & FolderNode::StatusMask) == bits) {
+        return false;
+    }
+    entry.flags = quint8((entry.flags & ~FolderNode::StatusMask) | bits);
+    return true;
+}
+
+bool FolderTreeModel::refreshChildFlags(int node)
+{
+    const FolderNode& entry = m_nodes[node];
+    quint8 bits = 0;
+    for (int i = 0; i < entry.childCount; ++i) {
+        const FolderNode& child = m_nodes[m_children[entry.childStart + i]];
+        if (child.isRepo()) {
+            bits |= (child.flags | child.childFlags) & FolderNode::AggregateMask;
         }
     }
-    return paths;
+    if (bits == entry.childFlags) {
+        return false;
+    }
+    m_nodes[node].childFlags = bits;
+    return true;
 }
 
-FolderItem* FolderTreeModel::getOrCreateFolder(const QString& path, FolderItem* parent)
+void FolderTreeModel::propagateUp(int node, QVector<int>* changed)
 {
-    if (m_pathToItem.contains(path)) {
-        return m_pathToItem[path];
+    // Only the direct children are looked at, so each level costs its
+    // submodule count; stop as soon as a summary is unchanged
+    for (int parent = m_nodes[node].parent;
+         parent > 0 && m_nodes[parent].isRepo() && refreshChildFlags(parent);
+         parent = m_nodes[parent].parent) {
+        changed->append(parent);
     }
+}
 
-    QDir dir(path);
-    FolderItem* item = new FolderItem(dir.dirName());
-    item->osPath = path;
-    item->relativePath = dir.dirName();
-    item->depth = parent ? parent->depth + 1 : 0;
-    item->isRepo = false;
-    item->updateIcon();
+void FolderTreeModel::emitStatusChanged(QVector<int> changed)
+{
+    // Group by parent then row, so siblings next to each other form a range
+    std::sort(changed.begin(), changed.end(), [this](int a, int b) {
+        const FolderNode& na = m_nodes[a];
+        const FolderNode& nb = m_nodes[b];
+        return na.parent != nb.parent ? na.parent < nb.parent : na.row < nb.row;
+    });
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
 
-    m_pathToItem[path] = item;
+    for (int i = 0; i < changed.size();) {
+        int last = i;
+        while (last + 1 < changed.size() &&
+               m_nodes[changed[last + 1]].parent == m_nodes[changed[i]].parent &&
+               m_nodes[changed[last + 1]].row == m_nodes[changed[last]].row + 1) {
+            ++last;
+        }
+        emit dataChanged(indexOf(changed[i]), indexOf(changed[last]), {Qt::DecorationRole});
+        i = last + 1;
+    }
+}
 
-    if (parent) {
-        parent->appendRow(item);
-    } else {
-        invisibleRootItem()->appendRow(item);
+void FolderTreeModel::updateRepoStatus(const QString& path, const RepoStatus& status)
+{
+    int id = findByPath(path);
+    if (applyStatus(id, status)) {
+        QVector<int> changed{id};
+        propagateUp(id, &changed);
+        emitStatusChanged(changed);
+    }
+}
+
+int FolderTreeModel::updateRepoStatuses(const QHash<QString, RepoStatus>& statuses)
+{
+    QVector<int> changed;
+    for (auto it = statuses.constBegin(); it != statuses.constEnd(); ++it) {
+        int id = findByPath(it.key());
+        if (applyStatus(id, it.value())) {
+            changed.append(id);
+        }
+    }
+    int count = changed.size();
+
+    // Submodule rows changed: refresh the repositories summarising them
+    for (int i = 0; i < count; ++i) {
+        propagateUp(changed[i], &changed);
     }
 
-    return item;
+    emitStatusChanged(changed);
+    return count;
+}
+
+QStringList FolderTreeModel::getAllRepoPaths() const
+{
+    QStringList paths;
+    for (int id = 1; id < m_nodes.size(); ++id) {
+        // Slots freed by a rescan are cleared and have no parent
+        if (m_nodes[id].isRepo() && m_nodes[id].parent >= 0) {
+            paths.append(nodePath(id));
+        }
+    }
+    return paths;
+}
+
+qint64 FolderTreeModel::memoryUsage() const
+{
+    qint64 bytes = qint64(m_nodes.capacity()) * qint64(sizeof(FolderNode));
+    bytes += qint64(m_children.capacity()) * qint64(sizeof(int));
+    bytes += qint64(m_freeNodes.capacity() + m_freeRepos.capacity()) * qint64(sizeof(int));
+    for (const RepoDirs& dirs : m_repos) {
+        bytes += qint64(sizeof(RepoDirs)) + 16 + (dirs.gitDir.size() + 1) * qint64(sizeof(QChar));
+        // Plain repositories share one string for both
+        if (dirs.commonDir.constData() != dirs.gitDir.constData()) {
+            bytes += 16 + (dirs.commonDir.size() + 1) * qint64(sizeof(QChar));
+        }
+    }
+    bytes += qint64(m_pathToNode.capacity()) * qint64(sizeof(PathInterner::Id) + sizeof(int) + 1);
+    bytes += qint64(m_dirs.capacity()) * qint64(sizeof(PathInterner::Id) + sizeof(DirRecord) + 1);
+    for (const DirRecord& record : m_dirs) {
+        bytes += qint64(record.subdirs.capacity()) * qint64(sizeof(PathInterner::Id));
+    }
+    return bytes + m_paths.memoryUsage();
 }
@@ -1,71 +1,180 @@
 #ifndef FOLDERTREEMODEL_H
 #define FOLDERTREEMODEL_H
 
-#include <QStandardItemModel>
-#include <QStandardItem>
+#include <QAbstractItemModel>
 #include <QString>
 #include <QStringList>
+#include <QVector>
 #include <QHash>
+#include <QSet>
+#include <QIcon>
 #include "git/GitStatus.h"
+#include "git/RefReader.h"
+#include "core/FileStat.h"
+#include "PathInterner.h"
+#include "DiscoveryFilter.h"
+
+struct StatResult;
 
 /**
- * FolderItem - Custom QStandardItem for folder tree
+ * FolderNode - One folder or repository in the flat node array of FolderTreeModel
+ *
+ * The children of a node are a contiguous range of FolderTreeModel's child
+ * table, so index(row, parent) is a plain array lookup. The path is an
+ * interned id and the repository status is packed into flags.
  */
-class FolderItem : public QStandardItem {
-public:
-    FolderItem(const QString& name);
-
-    QString osPath;           // Full filesystem path
-    QString relativePath;     // Relative path from root
-    int depth;                // Nesting level
-    bool isRepo;              // Is this a git repository?
-
-    // Repository status (only valid if isRepo)
-    bool needsPull;
-    bool needsPush;
-    bool needsCommit;
-    bool statusError;
-    bool statusChecked;
-
-    void updateIcon();
+struct FolderNode {
+    enum Flag : quint8 {
+        IsRepo        = 1 << 0,
+        NeedsPull     = 1 << 1,
+        NeedsPush     = 1 << 2,
+        NeedsCommit   = 1 << 3,
+        StatusError   = 1 << 4,
+        StatusChecked = 1 << 5,
+        StatusMask    = NeedsPull | NeedsPush | NeedsCommit | StatusError | StatusChecked,
+        AggregateMask = NeedsPull | NeedsPush | NeedsCommit | StatusError
+    };
+
+    int parent = -1;        // node id, 0 is the invisible root
+    int row = 0;            // position among the parent's children
+    int childStart = 0;     // first slot in the child table
+    int childCount = 0;
+    int repo = -1;          // slot in the repository table, -1 for plain folders
+    PathInterner::Id path = PathInterner::None;
+    quint16 depth = 0;
+    quint8 flags = 0;
+    quint8 childFlags = 0;  // AggregateMask bits of the repositories (submodules) below
+
+    bool isRepo() const { return flags & IsRepo; }
+    bool needsPull() const { return flags & NeedsPull; }
+    bool needsPush() const { return flags & NeedsPush; }
+    bool needsCommit() const { return flags & NeedsCommit; }
+    bool statusError() const { return flags & StatusError; }
+    bool statusChecked() const { return flags & StatusChecked; }
 };
 
 /**
  * FolderTreeModel - Tree structure model for repository discovery
+ *
+ * Nodes are referred to by id. Ids stay valid until the next full scan;
+ * a rescan only retires the ids of removed rows, which later rows reuse.
  */
-class FolderTreeModel : public QStandardItemModel {
+class FolderTreeModel : public QAbstractItemModel {
     Q_OBJECT
 
 public:
+    enum IconKind {
+        IconError, IconPull, IconPush, IconCommit, IconClean, IconUnchecked,
+        IconDrive, IconFolder, IconCount
+    };
+
     explicit FolderTreeModel(QObject *parent = nullptr);
 
+    // QAbstractItemModel
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+    // Depth, exclusions and symlink policy of later scans
+    void setDiscoveryOptions(const DiscoveryOptions& options);
+
     // Scan paths for repositories
     void scanPaths(const QStringList& paths);
 
-    // Get repository model at index
-    FolderItem* getItemAt(const QModelIndex& index) const;
+    // Bring the tree in line with the filesystem (and a possibly changed
+    // root list) without resetting it. Only directories whose mtime moved
+    // since the last walk are listed again.
+    void rescan(const QStringList& paths);
+
+    // Node id at index, -1 if the index is invalid
+    int nodeAt(const QModelIndex& index) const;
+    QModelIndex indexOf(int node) const;
+
+    // Find node by path, -1 if unknown
+    int findByPath(const QString& path) const;
 
-    // Find item by path
-    FolderItem* findByPath(const QString& path) const;
+    const FolderNode& node(int id) const { return m_nodes[id]; }
+    QString nodeName(int id) const { return m_paths.segment(m_nodes[id].path); }
+    QString nodePath(int id) const { return m_paths.path(m_nodes[id].path); }
+    QString gitDir(int id) const;       // Resolved git dir (differs from path/.git for worktrees)
+    QString commonDir(int id) const;    // Shared refs/objects dir (main repo of a worktree)
 
-    // Update status for a repository
+    // Update status for a repository, repaints only if the state changed
     void updateRepoStatus(const QString& path, const RepoStatus& status);
 
+    // Update many repositories in one pass: unchanged ones are skipped and
+    // changed sibling rows are merged into one dataChanged per range.
+    // Returns the number of repositories whose state changed.
+    int updateRepoStatuses(const QHash<QString, RepoStatus>& statuses);
+
     // Get all repository paths
     QStringList getAllRepoPaths() const;
 
     // Clear all items
     void clearAll();
 
+    // Approximate heap footprint of the tree in bytes
+    qint64 memoryUsage() const;
+
 signals:
     void scanProgress(int current, int total);
     void scanComplete();
 
 private:
-    QHash<QString, FolderItem*> m_pathToItem;
-
-    bool scanDirectory(const QString& path, FolderItem* parent, int depth);
-    FolderItem* getOrCreateFolder(const QString& path, FolderItem* parent);
+    struct RepoDirs {
+        QString gitDir;
+        QString commonDir;
+    };
+
+    // What the last walk saw in a directory
+    struct DirRecord {
+        qint64 mtimeNs = 0;
+        bool repo = false;
+        QVector<PathInterner::Id> subdirs;  // subdirectories to walk, in listing order
+    };
+
+    // Directory kept by a walk: a repository or a folder leading to one
+    struct ScanEntry {
+        PathInterner::Id path = PathInterner::None;
+        int depth = 0;
+        bool repo = false;
+        GitDirInfo git;                     // only set when resolved by this walk
+        QVector<ScanEntry> children;
+    };
+
+    QVector<FolderNode> m_nodes;        // m_nodes[0] is the invisible root
+    QVector<int> m_children;            // child ids, one contiguous range per node
+    QVector<RepoDirs> m_repos;
+    QVector<int> m_freeNodes;           // node ids retired by a rescan
+    QVector<int> m_freeRepos;           // repository slots retired by a rescan
+    int m_staleChildren = 0;            // m_children slots no range covers any more
+    PathInterner m_paths;
+    QHash<PathInterner::Id, int> m_pathToNode;
+    QHash<PathInterner::Id, DirRecord> m_dirs;  // every walked directory
+    DiscoveryFilter m_filter;
+    QSet<FileId> m_visited;             // directories seen by the current walk
+    int m_walkRootLength = 0;
+    mutable QIcon m_icons[IconCount];   // loaded on first use
+
+    void reset();
+    int addNode(PathInterner::Id path, int depth);
+    QVector<ScanEntry> walkRoots(const QStringList& paths);
+    // known: stat of path from the parent's batch, nullptr to stat it here
+    bool walkDirectory(const QString& path, PathInterner::Id id, int depth, ScanEntry* out,
+                       const StatResult* known = nullptr);
+    int buildSubtree(const ScanEntry& entry);
+    void dropSubtree(int node);
+    void syncChildren(int node, const QVector<ScanEntry>& wanted);
+    bool applyStatus(int node, const RepoStatus& status);
+    bool refreshChildFlags(int node);
+    void propagateUp(int node, QVector<int>* changed);
+    void emitStatusChanged(QVector<int> changed);
+    void setChildren(int parent, const QVector<int>& children);
+    void compactChildren();
+    QIcon icon(IconKind kind) const;
 };
 
 #endif // FOLDERTREEMODEL_H
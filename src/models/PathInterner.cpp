@@ -0,0 +1,109 @@
+#include "PathInterner.h"
+#include <cstring>
+
+PathInterner::Id PathInterner::intern(Id parent, const QString& segment)
+{
+    quint32 segmentId;
+    auto seg = m_segmentIds.constFind(segment);
+    if (seg != m_segmentIds.constEnd()) {
+        segmentId = seg.value();
+    } else {
+        segmentId = quint32(m_segments.size());
+        m_segments.append(segment);
+        m_segmentIds.insert(segment, segmentId);
+    }
+
+    quint64 key = childKey(parent, segmentId);
+    auto it = m_children.constFind(key);
+    if (it != m_children.constEnd()) {
+        return it.value();
+    }
+
+    Id id = Id(m_entries.size());
+    m_entries.append({parent, segmentId});
+    m_children.insert(key, id);
+    return id;
+}
+
+PathInterner::Id PathInterner::internPath(const QString& path)
+{
+    if (path.isEmpty()) {
+        return None;
+    }
+    Id id = None;
+    for (const QString& part : path.split(QLatin1Char('/'))) {
+        id = intern(id, part);
+    }
+    return id;
+}
+
+PathInterner::Id PathInterner::find(Id parent, const QString& segment) const
+{
+    auto seg = m_segmentIds.constFind(segment);
+    if (seg == m_segmentIds.constEnd()) {
+        return None;
+    }
+    return m_children.value(childKey(parent, seg.value()), None);
+}
+
+PathInterner::Id PathInterner::findPath(const QString& path) const
+{
+    if (path.isEmpty()) {
+        return None;
+    }
+    Id id = None;
+    for (const QString& part : path.split(QLatin1Char('/'))) {
+        id = find(id, part);
+        if (id == None) {
+            return None;
+        }
+    }
+    return id;
+}
+
+QString PathInterner::path(Id id) const
+{
+    if (id == None) {
+        return QString();
+    }
+
+    // Size the result in a first walk, then fill it from the end
+    qsizetype length = -1;
+    for (Id i = id; i != None; i = m_entries[i].parent) {
+        length += m_segments[m_entries[i].segment].size() + 1;
+    }
+
+    QString out(length, Qt::Uninitialized);
+    QChar* data = out.data();
+    qsizetype pos = length;
+    for (Id i = id; i != None; i = m_entries[i].parent) {
+        const QString& part = m_segments[m_entries[i].segment];
+        pos -= part.size();
+        std::memcpy(data + pos, part.constData(), size_t(part.size()) * sizeof(QChar));
+        if (m_entries[i].parent != None) {
+            data[--pos] = QLatin1Char('/');
+        }
+    }
+    return out;
+}
+
+void PathInterner::clear()
+{
+    m_entries.clear();
+    m_segments.clear();
+    m_segmentIds.clear();
+    m_children.clear();
+}
+
+qint64 PathInterner::memoryUsage() const
+{
+    qint64 bytes = qint64(m_entries.capacity()) * qint64(sizeof(Entry));
+
+    // Segment text is shared between the list and the hash keys
+    for (const QString& segment : m_segments) {
+        bytes += qint64(sizeof(QString)) + 16 + (segment.size() + 1) * qint64(sizeof(QChar));
+    }
+    bytes += qint64(m_segmentIds.capacity()) * qint64(sizeof(QString) + sizeof(quint32) + 1);
+    bytes += qint64(m_children.capacity()) * qint64(sizeof(quint64) + sizeof(Id) + 1);
+    return bytes;
+}
@@ -0,0 +1,61 @@
+#ifndef PATHINTERNER_H
+#define PATHINTERNER_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+
+/**
+ * PathInterner - Paths stored as chains of interned segments
+ *
+ * Each path is an id holding its parent's id and the id of its last
+ * segment, so a prefix shared by thousands of repositories is stored once.
+ * Lookups go through a hash keyed on (parent id, segment id); full strings
+ * are only rebuilt on demand by walking the parent chain.
+ *
+ * Paths are split on '/', a leading '/' becomes an empty first segment.
+ */
+class PathInterner {
+public:
+    using Id = quint32;
+    static constexpr Id None = 0xffffffffu;
+
+    PathInterner() = default;
+
+    // Id of parent/segment, created if needed (None as parent for a first segment)
+    Id intern(Id parent, const QString& segment);
+    // Id of a whole path, created if needed
+    Id internPath(const QString& path);
+
+    // Existing ids only, None if unknown
+    Id find(Id parent, const QString& segment) const;
+    Id findPath(const QString& path) const;
+
+    QString path(Id id) const;
+    QString segment(Id id) const { return m_segments[m_entries[id].segment]; }
+    Id parent(Id id) const { return m_entries[id].parent; }
+
+    int size() const { return m_entries.size(); }
+
+    void clear();
+
+    // Approximate heap footprint in bytes
+    qint64 memoryUsage() const;
+
+private:
+    struct Entry {
+        Id parent;
+        quint32 segment;
+    };
+
+    QVector<Entry> m_entries;
+    QVector<QString> m_segments;
+    QHash<QString, quint32> m_segmentIds;
+    QHash<quint64, Id> m_children;      // parent << 32 | segment -> id
+
+    static quint64 childKey(Id parent, quint32 segment) {
+        return (quint64(parent) << 32) | segment;
+    }
+};
+
+#endif // PATHINTERNER_H
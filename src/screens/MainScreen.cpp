@@ -4,9 +4,14 @@
 #include <QPixmap>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QTextStream>
 #include "icons/icons.h"
 
+// Repos prefetched around the selection, and repos kept in the cache
+static const int PREFETCH_REPOS = 3;
+static const int REPO_CACHE_SIZE = 16;
+
 MainScreen::MainScreen(QWidget *parent)
     : QWidget(parent)
     , m_folderModel(nullptr)
@@ -178,6 +183,9 @@ void MainScreen::setupConnections()
 
     // Tree connections
     connect(m_repoTree, &RepoTreeWidget::repoSelected, this, &MainScreen::onRepoSelected);
+    connect(m_repoTree, &RepoTreeWidget::pullAllRequested, this, &MainScreen::onPullAllRequested);
+    connect(m_repoTree, &RepoTreeWidget::pushAllRequested, this, &MainScreen::onPushAllRequested);
+    connect(m_repoTree, &RepoTreeWidget::mergeAllRequested, this, &MainScreen::onMergeAllRequested);
     connect(m_changesTree, &ChangesTreeWidget::filesChecked, this, &MainScreen::onFilesChecked);
     connect(m_changesTree, &ChangesTreeWidget::diffRequested, this, &MainScreen::onDiffRequested);
 
@@ -204,6 +212,8 @@ void MainScreen::setGitWorker(GitWorker* worker)
     if (worker) {
         connect(worker, &GitWorker::taskCompleted, this, &MainScreen::onGitTaskCompleted);
         connect(worker, &GitWorker::progressUpdate, this, &MainScreen::onProgressUpdate);
+        connect(worker, &GitWorker::batchItemCompleted, this, &MainScreen::onBatchItemCompleted);
+        connect(worker, &GitWorker::prefetchCompleted, this, &MainScreen::onPrefetchCompleted);
     }
 }
 
@@ -219,6 +229,46 @@ int MainScreen::generateRequestId()
     return m_nextRequestId++;
 }
 
+void MainScreen::applyBranches(const QVariantMap& data)
+{
+    QStringList local = data["local"].toStringList();
+    QStringList remote = data["remote"].toStringList();
+    QString current = data["current"].toString();
+
+    m_currentBranch = current;
+    m_branchSelector->setBranches(local, remote, current);
+
+    // Update merge selector
+    m_mergeSelector->clear();
+    for (const QString& b : local) {
+        if (b != current) {
+            m_mergeSelector->addItem(b);
+        }
+    }
+
+    // Update repo label
+    QString repoName = QDir(m_currentRepoPath).dirName();
+    m_repoLabel->setText(QString("%1 : %2").arg(repoName, current));
+
+    updateBranchVisibility();
+}
+
+void MainScreen::applyChanges(const QVariantMap& data)
+{
+    // Still UTF-8, rows decode their own path when shown
+    m_changesTree->setChanges(data["modified"].value<Utf8List>(), data["staged"].value<Utf8List>());
+}
+
+RepoStatus MainScreen::statusFromMap(const QVariantMap& statusMap)
+{
+    RepoStatus status;
+    status.needsPull = statusMap["needsPull"].toBool();
+    status.needsPush = statusMap["needsPush"].toBool();
+    status.needsCommit = statusMap["needsCommit"].toBool();
+    status.hasError = statusMap["hasError"].toBool();
+    return status;
+}
+
 void MainScreen::setLabel(const QString& message, const QString& tooltip)
 {
     m_statusBar->setStatus(message, tooltip);
@@ -308,7 +358,8 @@ void MainScreen::keyReleaseEvent(QKeyEvent* event)
 
 void MainScreen::onUpdateTreeClicked()
 {
-    updateAllRepoStatus();
+    // The controller rescans the configured roots, then refreshes status
+    emit rescanRequested();
 }
 
 void MainScreen::updateAllRepoStatus()
@@ -359,6 +410,13 @@ void MainScreen::onRepoSelected(const QString& path)
     QString repoName = QDir(path).dirName();
     m_repoLabel->setText(QString("%1 : ...").arg(repoName));
 
+    // Show what was prefetched right away, the requests below refresh it
+    auto cached = m_repoCache.constFind(path);
+    if (cached != m_repoCache.constEnd()) {
+        if (!cached->branches.isEmpty()) applyBranches(cached->branches);
+        if (!cached->changes.isEmpty()) applyChanges(cached->changes);
+    }
+
     // Request branch list
     if (m_gitWorker) {
         GitTaskRequest req;
@@ -373,6 +431,52 @@ void MainScreen::onRepoSelected(const QString& path)
         changesReq.repoPath = path;
         changesReq.requestId = generateRequestId();
         m_gitWorker->queueTask(changesReq);
+
+        prefetchLikelyNext();
+    }
+}
+
+void MainScreen::prefetchLikelyNext()
+{
+    // Earlier guesses are stale once the selection moved
+    m_gitWorker->clearPrefetchQueue();
+
+    for (const QString& path : m_repoTree->likelyNextRepos(PREFETCH_REPOS)) {
+        if (m_repoCache.contains(path)) continue;
+
+        for (GitTask task : { GitTask::GetBranches, GitTask::GetChanges }) {
+            GitTaskRequest req;
+            req.task = task;
+            req.repoPath = path;
+            req.requestId = generateRequestId();
+            req.prefetch = true;
+            m_gitWorker->queueTask(req);
+        }
+    }
+}
+
+void MainScreen::onPrefetchCompleted(GitTaskResult result)
+{
+    if (result.success) {
+        cacheRepoData(result);
+    }
+}
+
+void MainScreen::cacheRepoData(const GitTaskResult& result)
+{
+    if (result.repoPath.isEmpty()) return;
+
+    RepoSnapshot& entry = m_repoCache[result.repoPath];
+    if (result.task == GitTask::GetBranches) {
+        entry.branches = result.data.toMap();
+    } else if (result.task == GitTask::GetChanges) {
+        entry.changes = result.data.toMap();
+    }
+
+    m_repoCacheOrder.removeOne(result.repoPath);
+    m_repoCacheOrder.append(result.repoPath);
+    while (m_repoCacheOrder.size() > REPO_CACHE_SIZE) {
+        m_repoCache.remove(m_repoCacheOrder.takeFirst());
     }
 }
 
@@ -387,6 +491,7 @@ void MainScreen::onBranchChanged(const QString& branch)
     req.requestId = generateRequestId();
 
     setLabel(QString("Switching to branch: %1").arg(branch));
+    m_statusBar->showProgress(true);
     m_gitWorker->queueTask(req);
 }
 
@@ -487,15 +592,13 @@ void MainScreen::onCommitClicked()
         return;
     }
 
-    QStringList files = m_changesTree->getCheckedFiles();
-
     if (!m_gitWorker || m_currentRepoPath.isEmpty()) return;
 
     GitTaskRequest req;
     req.task = GitTask::Commit;
     req.repoPath = m_currentRepoPath;
     req.args << message;
-    req.args.append(files);
+    req.paths = m_changesTree->checkedPaths();
     req.requestId = generateRequestId();
 
     m_gitWorker->queueTask(req);
@@ -596,14 +699,87 @@ void MainScreen::onDiffRequested(const QString& file)
 void MainScreen::onProgressUpdate(int requestId, int percent, QString status)
 {
     m_statusBar->setProgress(percent);
+    if (!status.isEmpty()) {
+        m_statusBar->setProgressText(status);
+    }
+}
+
+void MainScreen::onPullAllRequested()
+{
+    if (!m_gitWorker || !m_folderModel) return;
+
+    GitTaskRequest req;
+    req.task = GitTask::PullAllClean;
+    req.args = m_folderModel->getAllRepoPaths();
+    req.requestId = generateRequestId();
+
+    setLabel("Pulling all clean repositories");
+    m_statusBar->showProgress(true);
+    m_gitWorker->queueTask(req);
+}
+
+void MainScreen::onPushAllRequested()
+{
+    if (!m_gitWorker || !m_folderModel) return;
+
+    GitTaskRequest req;
+    req.task = GitTask::PushAll;
+    req.args = m_folderModel->getAllRepoPaths();
+    req.requestId = generateRequestId();
+
+    setLabel("Pushing all repositories ahead");
+    m_statusBar->showProgress(true);
+    m_gitWorker->queueTask(req);
+}
+
+void MainScreen::onMergeAllRequested(const QStringList& repos, const QString& branch,
+                                     const QString& target)
+{
+    if (!m_gitWorker || repos.isEmpty()) return;
+
+    GitTaskRequest req;
+    req.task = GitTask::MergeAll;
+    req.args << branch << target << repos;
+    req.requestId = generateRequestId();
+
+    setLabel(QString("Merging '%1' into '%2' in %3 repositories").arg(branch, target).arg(repos.size()));
+    m_statusBar->showProgress(true);
+    m_gitWorker->queueTask(req);
+}
+
+void MainScreen::onBatchItemCompleted(GitTaskResult result)
+{
+    // Per-repo result of a bulk task, applied as it streams in
+    QVariantMap data = result.data.toMap();
+    if (data.contains("path") && data.contains("status") && m_folderModel) {
+        m_folderModel->updateRepoStatus(data["path"].toString(),
+                                        statusFromMap(data["status"].toMap()));
+    }
 }
 
 void MainScreen::onGitTaskCompleted(GitTaskResult result)
 {
     m_statusBar->showProgress(false);
 
+    // Keep the repo cache in step: reads refresh it, anything else may
+    // have changed branches or files (bulk tasks touch many repos)
+    if (result.task == GitTask::GetBranches || result.task == GitTask::GetChanges) {
+        if (result.success) cacheRepoData(result);
+    } else if (result.task != GitTask::GetDiff && result.task != GitTask::CheckStatus &&
+               result.task != GitTask::CheckAllStatus) {
+        if (result.repoPath.isEmpty()) {
+            m_repoCache.clear();
+            m_repoCacheOrder.clear();
+        } else {
+            m_repoCache.remove(result.repoPath);
+            m_repoCacheOrder.removeOne(result.repoPath);
+        }
+    }
+
     if (!result.success) {
-        setLabel(result.message);
+        // Merge pre-check: full list of conflicting paths in the tooltip
+        QStringList conflicts = result.data.toMap().value("conflicts").toStringList();
+        setLabel(result.message, conflicts.join("\n"));
         m_pendingPush = false;  // Cancel pending push on any failure
         return;
     }
@@ -629,7 +805,9 @@ void MainScreen::onGitTaskCompleted(GitTaskResult result)
         result.task == GitTask::Checkout ||
         result.task == GitTask::Pull ||
         result.task == GitTask::Merge ||
-        result.task == GitTask::StashPop) {
+        result.task == GitTask::StashPop ||
+        result.task == GitTask::PullAllClean ||
+        result.task == GitTask::MergeAll) {
         // Request updated changes list
         if (!m_currentRepoPath.isEmpty() && m_gitWorker) {
             GitTaskRequest req;
@@ -668,57 +846,23 @@ void MainScreen::onGitTaskCompleted(GitTaskResult result)
     if (result.data.type() == QVariant::Map) {
         QVariantMap data = result.data.toMap();
 
-        // Handle GetBranches result
-        if (data.contains("local") && data.contains("remote")) {
-            QStringList local = data["local"].toStringList();
-            QStringList remote = data["remote"].toStringList();
-            QString current = data["current"].toString();
-
-            m_currentBranch = current;
-            m_branchSelector->setBranches(local, remote, current);
-
-            // Update merge selector
-            m_mergeSelector->clear();
-            for (const QString& b : local) {
-                if (b != current) {
-                    m_mergeSelector->addItem(b);
-                }
-            }
-
-            // Update repo label
-            QString repoName = QDir(m_currentRepoPath).dirName();
-            m_repoLabel->setText(QString("%1 : %2").arg(repoName, current));
+        // Results for a repo that is no longer selected only feed the cache
+        bool forCurrent = result.repoPath.isEmpty() || result.repoPath == m_currentRepoPath;
 
-            updateBranchVisibility();
+        // Handle GetBranches result
+        if (data.contains("local") && data.contains("remote") && forCurrent) {
+            applyBranches(data);
         }
 
         // Handle GetChanges result
-        if (data.contains("modified") && data.contains("staged")) {
-            QStringList modified = data["modified"].toStringList();
-            QStringList staged = data["staged"].toStringList();
-
-            QList<FileChange> unstagedChanges;
-            for (const QString& f : modified) {
-                unstagedChanges.append(FileChange(f, FileStatus::Modified, false));
-            }
-
-            QList<FileChange> stagedChanges;
-            for (const QString& f : staged) {
-                stagedChanges.append(FileChange(f, FileStatus::Staged, true));
-            }
-
-            m_changesTree->setChanges(unstagedChanges, stagedChanges);
+        if (data.contains("modified") && data.contains("staged") && forCurrent) {
+            applyChanges(data);
         }
 
         // Handle CheckAllStatus result
         if (data.contains("path") && data.contains("status")) {
             QString path = data["path"].toString();
-            QVariantMap statusMap = data["status"].toMap();
-            RepoStatus status;
-            status.needsPull = statusMap["needsPull"].toBool();
-            status.needsPush = statusMap["needsPush"].toBool();
-            status.needsCommit = statusMap["needsCommit"].toBool();
-            status.hasError = statusMap["hasError"].toBool();
+            RepoStatus status = statusFromMap(data["status"].toMap());
 
             if (m_folderModel) {
                 m_folderModel->updateRepoStatus(path, status);
@@ -726,23 +870,18 @@ void MainScreen::onGitTaskCompleted(GitTaskResult result)
         }
     }
 
-    // Handle list of status updates
-    if (result.data.type() == QVariant::List) {
+    // Handle list of status updates, applied to the tree in one pass
+    if (result.task == GitTask::CheckAllStatus && result.data.type() == QVariant::List) {
         QVariantList statusList = result.data.toList();
+        QHash<QString, RepoStatus> statuses;
+        statuses.reserve(statusList.size());
         for (const QVariant& item : statusList) {
             QVariantMap repoData = item.toMap();
-            QString path = repoData["path"].toString();
-            QVariantMap statusMap = repoData["status"].toMap();
-
-            RepoStatus status;
-            status.needsPull = statusMap["needsPull"].toBool();
-            status.needsPush = statusMap["needsPush"].toBool();
-            status.needsCommit = statusMap["needsCommit"].toBool();
-            status.hasError = statusMap["hasError"].toBool();
+            statuses.insert(repoData["path"].toString(), statusFromMap(repoData["status"].toMap()));
+        }
 
-            if (m_folderModel) {
-                m_folderModel->updateRepoStatus(path, status);
-            }
+        if (m_folderModel) {
+            m_folderModel->updateRepoStatuses(statuses);
         }
     }
 
@@ -754,5 +893,13 @@ void MainScreen::onGitTaskCompleted(GitTaskResult result)
         dialog.exec();
     }
 
-    setLabel(result.message);
+    // Bulk tasks: per-repository report in the tooltip
+    QStringList report;
+    for (const QVariant& item : result.data.toMap().value("batch").toList()) {
+        QVariantMap entry = item.toMap();
+        report << QString("%1: %2").arg(QFileInfo(entry["path"].toString()).fileName(),
+                                        entry["message"].toString());
+    }
+
+    setLabel(result.message, report.join("\n"));
 }
@@ -34,9 +34,11 @@ public:
 signals:
     void statusChanged(const QString& message, const QString& tooltip);
     void gitTaskRequested(GitTaskRequest request);
+    void rescanRequested();
 
 public slots:
     void onGitTaskCompleted(GitTaskResult result);
+    void onBatchItemCompleted(GitTaskResult result);
     void onRepoSelected(const QString& path);
     void onBranchChanged(const QString& branch);
     void onFilesChecked(const QStringList& files);
@@ -63,6 +65,10 @@ private slots:
     void onNewBranchRequested(const QString& name);
     void onDiffRequested(const QString& file);
     void onProgressUpdate(int requestId, int percent, QString status);
+    void onPullAllRequested();
+    void onPushAllRequested();
+    void onMergeAllRequested(const QStringList& repos, const QString& branch, const QString& target);
+    void onPrefetchCompleted(GitTaskResult result);
 
 private:
     // Widgets
@@ -101,6 +107,14 @@ private:
     bool m_isMasterBranch;
     bool m_pendingPush;
 
+    // Branch and change data per repo, filled by prefetch and by visits
+    struct RepoSnapshot {
+        QVariantMap branches;
+        QVariantMap changes;
+    };
+    QHash<QString, RepoSnapshot> m_repoCache;
+    QStringList m_repoCacheOrder;           // least recently used first
+
     // Timers
     QTimer* m_spinnerTimer;
     QTimer* m_changesUpdateTimer;
@@ -119,6 +133,11 @@ private:
     void unlockButtons();
     void updateBranchVisibility();
     int generateRequestId();
+    static RepoStatus statusFromMap(const QVariantMap& statusMap);
+    void applyBranches(const QVariantMap& data);
+    void applyChanges(const QVariantMap& data);
+    void cacheRepoData(const GitTaskResult& result);
+    void prefetchLikelyNext();
 
     QIcon loadIcon(const unsigned char* data, unsigned int len);
 };
@@ -1,4 +1,6 @@
 #include "BranchSelector.h"
+#include <QLineEdit>
+#include <QSet>
 
 BranchSelector::BranchSelector(QWidget *parent)
     : QWidget(parent)
@@ -12,12 +14,29 @@ void BranchSelector::setupUi()
     QHBoxLayout* layout = new QHBoxLayout(this);
     layout->setContentsMargins(0, 0, 0, 0);
 
+    m_model = new QStringListModel(this);
+
     m_combo = new QComboBox(this);
     m_combo->setMinimumWidth(150);
     m_combo->setMinimumHeight(25);
+    m_combo->setModel(m_model);
+
+    // Type-ahead: editable, but typed text never becomes an item
+    m_combo->setEditable(true);
+    m_combo->setInsertPolicy(QComboBox::NoInsert);
+
+    m_completer = new QCompleter(m_model, this);
+    m_completer->setCaseSensitivity(Qt::CaseInsensitive);
+    m_completer->setFilterMode(Qt::MatchContains);
+    m_completer->setCompletionMode(QCompleter::PopupCompletion);
+    m_combo->setCompleter(m_completer);
 
     connect(m_combo, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, &BranchSelector::onComboChanged);
+    connect(m_completer, QOverload<const QString&>::of(&QCompleter::activated),
+            this, &BranchSelector::onCompleterActivated);
+    connect(m_combo->lineEdit(), &QLineEdit::editingFinished,
+            this, &BranchSelector::onEditingFinished);
 
     layout->addWidget(m_combo);
     setLayout(layout);
@@ -33,17 +52,20 @@ void BranchSelector::setBranches(const QStringList& local, const QStringList& re
     m_ignoreChanges = true;
     m_currentBranch = current;
 
-    m_combo->clear();
+    // Build the whole list first, the model is reset once
+    QStringList items;
+    items.reserve(local.size() + remote.size() + 2);
 
     // Add current branch first
     if (!current.isEmpty()) {
-        m_combo->addItem(current);
+        items.append(current);
     }
 
     // Add other local branches
+    QSet<QString> localSet(local.begin(), local.end());
     for (const QString& branch : local) {
         if (branch != current) {
-            m_combo->addItem(branch);
+            items.append(branch);
         }
     }
 
@@ -56,13 +78,14 @@ void BranchSelector::setBranches(const QStringList& local, const QStringList& re
         }
 
         // Only add if not already in local branches
-        if (!local.contains(branchName) && branchName != current) {
-            m_combo->addItem(QString("<%1>").arg(branchName));
+        if (!localSet.contains(branchName) && branchName != current) {
+            items.append(QString("<%1>").arg(branchName));
         }
     }
 
     // Add --new-- option
-    m_combo->addItem("--new--");
+    items.append("--new--");
+    m_model->setStringList(items);
 
     // Select current branch
     m_combo->setCurrentIndex(0);
@@ -78,11 +101,27 @@ void BranchSelector::setEnabled(bool enabled)
 void BranchSelector::clear()
 {
     m_ignoreChanges = true;
-    m_combo->clear();
+    m_model->setStringList(QStringList());
     m_currentBranch.clear();
     m_ignoreChanges = false;
 }
 
+void BranchSelector::onCompleterActivated(const QString& text)
+{
+    int index = m_combo->findText(text);
+    if (index >= 0) {
+        m_combo->setCurrentIndex(index);
+    }
+}
+
+void BranchSelector::onEditingFinished()
+{
+    // Typed text that matches no branch falls back to the selection
+    if (m_combo->findText(m_combo->currentText()) < 0) {
+        m_combo->setEditText(m_combo->itemText(m_combo->currentIndex()));
+    }
+}
+
 void BranchSelector::onComboChanged(int index)
 {
     if (m_ignoreChanges || index < 0) {
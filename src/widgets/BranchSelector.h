@@ -5,9 +5,15 @@
 #include <QComboBox>
 #include <QHBoxLayout>
 #include <QStringList>
+#include <QStringListModel>
+#include <QCompleter>
 
 /**
  * BranchSelector - Branch selection dropdown
+ *
+ * Backed by a QStringListModel filled in one go; typing filters it through
+ * a case-insensitive "contains" completer, so repos with thousands of
+ * remote branches stay usable.
  */
 class BranchSelector : public QWidget {
     Q_OBJECT
@@ -28,9 +34,13 @@ public slots:
 
 private slots:
     void onComboChanged(int index);
+    void onCompleterActivated(const QString& text);
+    void onEditingFinished();
 
 private:
     QComboBox* m_combo;
+    QStringListModel* m_model;
+    QCompleter* m_completer;
     QString m_currentBranch;
     bool m_ignoreChanges;
 
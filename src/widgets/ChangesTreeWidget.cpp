@@ -1,6 +1,33 @@
 #include "ChangesTreeWidget.h"
 #include <QHeaderView>
 
+namespace {
+
+// File row whose text is decoded from its list on each request
+class PathItem : public QTreeWidgetItem {
+public:
+    PathItem(const Utf8List& paths, int index)
+        : QTreeWidgetItem(UserType)
+        , m_paths(paths)
+        , m_index(index)
+    {}
+
+    QVariant data(int column, int role) const override {
+        if (column == 0 && (role == Qt::DisplayRole || role == Qt::ToolTipRole)) {
+            return m_paths.at(m_index);
+        }
+        return QTreeWidgetItem::data(column, role);
+    }
+
+    QByteArrayView path() const { return m_paths.view(m_index); }
+
+private:
+    Utf8List m_paths;   // Shared, not copied
+    int m_index;
+};
+
+} // namespace
+
 ChangesTreeWidget::ChangesTreeWidget(QWidget *parent)
     : QTreeWidget(parent)
     , m_allItem(nullptr)
@@ -29,9 +56,12 @@ void ChangesTreeWidget::setupUi()
     // Visual settings
     setRootIsDecorated(false);
     setIndentation(0);
+
+    // Row heights from the first row only, so off-screen paths stay encoded
+    setUniformRowHeights(true);
 }
 
-void ChangesTreeWidget::setChanges(const QList<FileChange>& unstaged, const QList<FileChange>& staged)
+void ChangesTreeWidget::setChanges(const Utf8List& unstaged, const Utf8List& staged)
 {
     m_ignoreChanges = true;
     clear();
@@ -55,15 +85,17 @@ void ChangesTreeWidget::setChanges(const QList<FileChange>& unstaged, const QLis
         m_allItem->setFlags(m_allItem->flags() | Qt::ItemIsUserCheckable);
         m_allItem->setCheckState(0, Qt::Unchecked);
 
-        // Add each file
-        for (const FileChange& change : unstaged) {
-            QTreeWidgetItem* item = new QTreeWidgetItem(this);
-            item->setText(0, change.path);
+        // Add each file, inserted in one go
+        QList<QTreeWidgetItem*> items;
+        items.reserve(unstaged.size());
+        for (int i = 0; i < unstaged.size(); i++) {
+            QTreeWidgetItem* item = new PathItem(unstaged, i);
             item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
             item->setCheckState(0, Qt::Unchecked);
-            item->setToolTip(0, change.path);
-            m_fileItems.append(item);
+            items.append(item);
         }
+        addTopLevelItems(items);
+        m_fileItems = items;
     }
 
     // Add cached/staged files header
@@ -72,12 +104,14 @@ void ChangesTreeWidget::setChanges(const QList<FileChange>& unstaged, const QLis
         cachedHeader->setText(0, "---- Cached files ----");
         cachedHeader->setFlags(cachedHeader->flags() & ~Qt::ItemIsUserCheckable);
 
-        for (const FileChange& change : staged) {
-            QTreeWidgetItem* item = new QTreeWidgetItem(this);
-            item->setText(0, change.path);
+        QList<QTreeWidgetItem*> items;
+        items.reserve(staged.size());
+        for (int i = 0; i < staged.size(); i++) {
+            QTreeWidgetItem* item = new PathItem(staged, i);
             item->setFlags(item->flags() & ~Qt::ItemIsUserCheckable);
-            item->setToolTip(0, change.path);
+            items.append(item);
         }
+        addTopLevelItems(items);
     }
 
     m_ignoreChanges = false;
@@ -103,6 +137,17 @@ QStringList ChangesTreeWidget::getCheckedFiles() const
     return files;
 }
 
+Utf8List ChangesTreeWidget::checkedPaths() const
+{
+    Utf8List paths;
+    for (QTreeWidgetItem* item : m_fileItems) {
+        if (item->checkState(0) == Qt::Checked) {
+            paths.append(static_cast<PathItem*>(item)->path());
+        }
+    }
+    return paths;
+}
+
 void ChangesTreeWidget::onItemChanged(QTreeWidgetItem* item, int column)
 {
     if (m_ignoreChanges || column != 0) {
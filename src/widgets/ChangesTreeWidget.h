@@ -6,9 +6,13 @@
 #include <QList>
 #include <QMenu>
 #include "git/GitStatus.h"
+#include "core/Utf8List.h"
 
 /**
  * ChangesTreeWidget - Tree widget for displaying file changes
+ *
+ * File rows keep a reference to the UTF-8 lists they came from and decode
+ * their path only when the view asks for it, i.e. for rows on screen.
  */
 class ChangesTreeWidget : public QTreeWidget {
     Q_OBJECT
@@ -17,13 +21,15 @@ public:
     explicit ChangesTreeWidget(QWidget *parent = nullptr);
 
     QStringList getCheckedFiles() const;
+    // Checked paths as raw UTF-8, for handing back to the worker
+    Utf8List checkedPaths() const;
 
 signals:
     void filesChecked(const QStringList& files);
     void diffRequested(const QString& file);
 
 public slots:
-    void setChanges(const QList<FileChange>& unstaged, const QList<FileChange>& staged);
+    void setChanges(const Utf8List& unstaged, const Utf8List& staged);
     void clearChanges();
 
 private slots:
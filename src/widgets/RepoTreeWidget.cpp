@@ -1,5 +1,10 @@
 #include "RepoTreeWidget.h"
 #include <QHeaderView>
+#include <QMenu>
+#include <QInputDialog>
+#include <QSet>
+#include <algorithm>
+#include <functional>
 #include "icons/icons.h"
 
 RepoTreeWidget::RepoTreeWidget(QWidget *parent)
@@ -26,8 +31,8 @@ void RepoTreeWidget::setupUi()
     // Enable animated expansion
     setAnimated(true);
 
-    // Selection mode
-    setSelectionMode(QAbstractItemView::SingleSelection);
+    // Selection mode, several rows for bulk merges
+    setSelectionMode(QAbstractItemView::ExtendedSelection);
 
     // Allow clicking on items
     setAllColumnsShowFocus(true);
@@ -36,6 +41,10 @@ void RepoTreeWidget::setupUi()
     connect(this, &QTreeView::doubleClicked, this, &RepoTreeWidget::onDoubleClicked);
     connect(this, &QTreeView::clicked, this, &RepoTreeWidget::onClicked);
 
+    // Context menu for bulk operations
+    setContextMenuPolicy(Qt::CustomContextMenu);
+    connect(this, &QTreeView::customContextMenuRequested, this, &RepoTreeWidget::onContextMenu);
+
     // Setup spinner timer
     m_spinnerTimer = new QTimer(this);
     m_spinnerTimer->setInterval(200);  // 200ms per frame
@@ -52,23 +61,84 @@ void RepoTreeWidget::onClicked(const QModelIndex& index)
 {
     if (!m_model) return;
 
-    FolderItem* item = m_model->getItemAt(index);
-    if (!item) return;
+    int node = m_model->nodeAt(index);
+    if (node < 0) return;
 
-    if (item->isRepo) {
-        emit repoSelected(item->osPath);
+    if (m_model->node(node).isRepo()) {
+        emit repoSelected(m_model->nodePath(node));
     }
 }
 
+QStringList RepoTreeWidget::likelyNextRepos(int max) const
+{
+    QStringList repos;
+    if (!m_model || !currentIndex().isValid()) return repos;
+
+    auto repoAt = [this](const QModelIndex& index) -> int {
+        int node = m_model->nodeAt(index);
+        return (node >= 0 && m_model->node(node).isRepo()) ? node : -1;
+    };
+
+    // Nearest repo above
+    for (QModelIndex i = indexAbove(currentIndex()); i.isValid(); i = indexAbove(i)) {
+        int node = repoAt(i);
+        if (node >= 0) {
+            repos.append(m_model->nodePath(node));
+            break;
+        }
+    }
+
+    // Nearest repo below, then dirty ones
+    bool first = true;
+    for (QModelIndex i = indexBelow(currentIndex()); i.isValid() && repos.size() < max; i = indexBelow(i)) {
+        int node = repoAt(i);
+        if (node < 0) continue;
+        if (first || m_model->node(node).needsCommit()) {
+            repos.append(m_model->nodePath(node));
+            first = false;
+        }
+    }
+
+    return repos.mid(0, max);
+}
+
+QStringList RepoTreeWidget::selectedRepoPaths() const
+{
+    QStringList repos;
+    if (!m_model) return repos;
+
+    QModelIndexList selected = selectionModel()->selectedRows();
+    std::sort(selected.begin(), selected.end(), [this](const QModelIndex& a, const QModelIndex& b) {
+        return visualRect(a).top() < visualRect(b).top();
+    });
+
+    QSet<int> seen;
+    std::function<void(const QModelIndex&)> collect = [&](const QModelIndex& index) {
+        int node = m_model->nodeAt(index);
+        if (node < 0 || seen.contains(node)) return;
+        seen.insert(node);
+        if (m_model->node(node).isRepo()) {
+            repos.append(m_model->nodePath(node));
+        }
+        for (int row = 0; row < m_model->rowCount(index); ++row) {
+            collect(m_model->index(row, 0, index));
+        }
+    };
+    for (const QModelIndex& index : selected) {
+        collect(index);
+    }
+    return repos;
+}
+
 void RepoTreeWidget::onDoubleClicked(const QModelIndex& index)
 {
     if (!m_model) return;
 
-    FolderItem* item = m_model->getItemAt(index);
-    if (!item) return;
+    int node = m_model->nodeAt(index);
+    if (node < 0) return;
 
-    if (item->isRepo) {
-        emit repoSelected(item->osPath);
+    if (m_model->node(node).isRepo()) {
+        emit repoSelected(m_model->nodePath(node));
     } else {
         // Toggle expand/collapse for folders
         if (isExpanded(index)) {
@@ -79,6 +149,33 @@ void RepoTreeWidget::onDoubleClicked(const QModelIndex& index)
     }
 }
 
+void RepoTreeWidget::onContextMenu(const QPoint& pos)
+{
+    QMenu menu(this);
+    QAction* pullAllAction = menu.addAction("Pull all clean repositories");
+    QAction* pushAllAction = menu.addAction("Push all repositories ahead");
+    QAction* mergeAllAction = menu.addAction("Merge branch into selected repositories...");
+    QStringList selectedRepos = selectedRepoPaths();
+    mergeAllAction->setEnabled(!selectedRepos.isEmpty());
+
+    QAction* selected = menu.exec(viewport()->mapToGlobal(pos));
+    if (selected == pullAllAction) {
+        emit pullAllRequested();
+    } else if (selected == pushAllAction) {
+        emit pushAllRequested();
+    } else if (selected == mergeAllAction) {
+        QString title = QString("Merge into %1 repositories").arg(selectedRepos.size());
+        QString branch = QInputDialog::getText(this, title, "Branch to merge:").trimmed();
+        if (branch.isEmpty()) return;
+        // Repositories checked out on another branch are skipped, not merged into
+        QString target = QInputDialog::getText(this, title,
+                                               QString("Merge '%1' into branch:").arg(branch)).trimmed();
+        if (!target.isEmpty()) {
+            emit mergeAllRequested(selectedRepos, branch, target);
+        }
+    }
+}
+
 void RepoTreeWidget::updateRepoStatus(const QString& path, const RepoStatus& status)
 {
     if (m_model) {
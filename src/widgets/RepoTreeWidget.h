@@ -18,9 +18,20 @@ public:
     void setFolderModel(FolderTreeModel* model);
     FolderTreeModel* folderModel() const { return m_model; }
 
+    // Repos likely to be opened next: the ones right above and below the
+    // current one, then repos needing a commit further down, in display order
+    QStringList likelyNextRepos(int max) const;
+
+    // Repositories of the selected rows, a selected folder counting for
+    // every repository below it, in display order
+    QStringList selectedRepoPaths() const;
+
 signals:
     void repoSelected(const QString& path);
     void refreshRequested();
+    void pullAllRequested();
+    void pushAllRequested();
+    void mergeAllRequested(const QStringList& repos, const QString& branch, const QString& target);
 
 public slots:
     void updateRepoStatus(const QString& path, const RepoStatus& status);
@@ -30,6 +41,7 @@ public slots:
 private slots:
     void onClicked(const QModelIndex& index);
     void onDoubleClicked(const QModelIndex& index);
+    void onContextMenu(const QPoint& pos);
     void updateSpinner();
 
 private:
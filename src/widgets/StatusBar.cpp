@@ -52,6 +52,7 @@ void StatusBar::showProgress(bool visible)
     m_label->setVisible(!visible);
     if (visible) {
         m_progress->setValue(0);
+        setProgressText(QString());
     }
 }
 
@@ -60,6 +61,13 @@ void StatusBar::setProgress(int percent)
     m_progress->setValue(percent);
 }
 
+void StatusBar::setProgressText(const QString& text)
+{
+    // Transfer details (objects, bytes, throughput) drawn inside the bar
+    m_progress->setFormat(text);
+    m_progress->setTextVisible(!text.isEmpty());
+}
+
 void StatusBar::clearStatus()
 {
     m_label->setText("");
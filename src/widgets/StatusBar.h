@@ -20,6 +20,7 @@ public slots:
     void setStatus(const QString& message, const QString& tooltip);
     void showProgress(bool visible);
     void setProgress(int percent);
+    void setProgressText(const QString& text);
     void clearStatus();
 
 private:
@@ -1,8 +1,22 @@
 #include "GitWorker.h"
+#include <QDateTime>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QDebug>
+#include <QSet>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QUrl>
+#include <QLocale>
+#include <atomic>
+#include <cstring>
+#include <vector>
 #include <git2.h>
+#include "core/FileStat.h"
+#include "core/PathFilter.h"
+#include "git/IndexReader.h"
+#include "git/RefReader.h"
 
 // Certificate check callback - accept known hosts
 static int certificate_check_callback(git_cert *cert, int valid, const char *host, void *payload)
@@ -15,34 +29,113 @@ static int certificate_check_callback(git_cert *cert, int valid, const char *hos
     return 0;  // 0 = accept, negative = reject
 }
 
+// SSH credential that worked for a "user@host", reused across repositories
+// so a bulk task does not walk ~/.ssh again for every remote on the same host
+struct CredentialCache {
+    QMutex mutex;
+    QHash<QString, QString> methods;    // "user@host" -> "agent" or private key path
+};
+
+static CredentialCache s_credentialCache;
+
+static QString credentialKey(const char* url, const char* user)
+{
+    QString host = QUrl(QString::fromUtf8(url)).host();
+    if (host.isEmpty()) {
+        // scp-like syntax: "git@host:owner/repo.git"
+        QString u = QString::fromUtf8(url);
+        host = u.section('@', -1).section(':', 0, 0);
+    }
+    return QString::fromUtf8(user) + QLatin1Char('@') + host;
+}
+
+static int sshKeyCredential(git_credential **out, const char* user, const QString& privKey)
+{
+    QString pubKey = privKey + ".pub";
+    return git_credential_ssh_key_new(out, user,
+        pubKey.toUtf8().constData(),
+        privKey.toUtf8().constData(),
+        nullptr);  // passphrase - nullptr means no passphrase
+}
+
+// Progress sink of a long operation: percent and a human readable status
+using ProgressFn = std::function<void(int, const QString&)>;
+
+// Payload of the remote callbacks: auth state and transfer progress
+struct RemotePayload {
+    int attempts = 0;
+    QString cachedMethod;               // method offered on the first attempt
+    ProgressFn progress;                // optional
+    QElapsedTimer clock;                // started with the transfer
+    qint64 lastReportMs = -1;
+
+    // At most ~10 reports a second, the last one always goes through
+    bool shouldReport(bool last) {
+        if (!progress) return false;
+        qint64 now = clock.elapsed();
+        if (!last && lastReportMs >= 0 && now - lastReportMs < 100) return false;
+        lastReportMs = now;
+        return true;
+    }
+
+    QString throughput(quint64 bytes) const {
+        qint64 ms = qMax<qint64>(clock.elapsed(), 1);
+        return QLocale().formattedDataSize(static_cast<qint64>(bytes)) + " at " +
+               QLocale().formattedDataSize(static_cast<qint64>(bytes * 1000 / ms)) + "/s";
+    }
+};
+
 // SSH credential callback for libgit2
-// payload contains a pointer to retry counter
+// payload contains a pointer to RemotePayload
 static int credentials_callback(git_credential **out, const char *url,
                                  const char *username_from_url,
                                  unsigned int allowed_types, void *payload)
 {
-    int* attempts = static_cast<int*>(payload);
-    if (attempts) {
-        (*attempts)++;
-        if (*attempts > 3) {
-            qDebug() << "Auth failed after" << (*attempts - 1) << "attempts, giving up";
+    RemotePayload* auth = static_cast<RemotePayload*>(payload);
+    if (auth) {
+        auth->attempts++;
+        if (auth->attempts > 3) {
+            qDebug() << "Auth failed after" << (auth->attempts - 1) << "attempts, giving up";
             return GIT_EUSER;
         }
     }
 
     qDebug() << "Auth requested for:" << url << "user:" << username_from_url
-             << "allowed:" << allowed_types << "attempt:" << (attempts ? *attempts : 0);
+             << "allowed:" << allowed_types << "attempt:" << (auth ? auth->attempts : 0);
 
-    // Try SSH agent first (most common for git over SSH)
     if (allowed_types & GIT_CREDENTIAL_SSH_KEY) {
         const char* user = username_from_url ? username_from_url : "git";
+        QString key = credentialKey(url, user);
+
+        // First attempt: offer what worked last time for this host.
+        // If libgit2 asks again the cached method was rejected, drop it.
+        if (auth && auth->attempts == 1) {
+            QMutexLocker locker(&s_credentialCache.mutex);
+            auth->cachedMethod = s_credentialCache.methods.value(key);
+        } else if (auth && !auth->cachedMethod.isEmpty()) {
+            QMutexLocker locker(&s_credentialCache.mutex);
+            s_credentialCache.methods.remove(key);
+            auth->cachedMethod.clear();
+        }
+
+        if (auth && auth->attempts == 1 && !auth->cachedMethod.isEmpty()) {
+            int ret = auth->cachedMethod == "agent"
+                ? git_credential_ssh_key_from_agent(out, user)
+                : sshKeyCredential(out, user, auth->cachedMethod);
+            if (ret == 0) {
+                return 0;
+            }
+        }
 
+        // Try SSH agent first (most common for git over SSH)
         // Check if SSH_AUTH_SOCK is available
         const char* authSock = getenv("SSH_AUTH_SOCK");
         if (authSock && authSock[0] != '\0') {
             int ret = git_credential_ssh_key_from_agent(out, user);
             if (ret == 0) {
                 qDebug() << "Using SSH agent for auth";
+                QMutexLocker locker(&s_credentialCache.mutex);
+                s_credentialCache.methods.insert(key, "agent");
                 return 0;
             }
             qDebug() << "SSH agent failed (ret=" << ret << ")";
@@ -56,15 +149,13 @@ static int credentials_callback(git_credential **out, const char *url,
 
         for (const QString& pubFile : pubKeys) {
             QString privKey = sshDir.filePath(pubFile.chopped(4));  // remove .pub
-            QString pubKey = sshDir.filePath(pubFile);
 
             if (QFile::exists(privKey)) {
                 qDebug() << "Trying SSH key:" << privKey;
-                int ret = git_credential_ssh_key_new(out, user,
-                    pubKey.toUtf8().constData(),
-                    privKey.toUtf8().constData(),
-                    nullptr);  // passphrase - nullptr means no passphrase
+                int ret = sshKeyCredential(out, user, privKey);
                 if (ret == 0) {
+                    QMutexLocker locker(&s_credentialCache.mutex);
+                    s_credentialCache.methods.insert(key, privKey);
                     return 0;
                 }
                 qDebug() << "Key failed (ret=" << ret << ")";
@@ -83,6 +174,62 @@ static int credentials_callback(git_credential **out, const char *url,
     return GIT_EUSER;
 }
 
+static int transfer_progress_callback(const git_indexer_progress* stats, void* payload)
+{
+    RemotePayload* remote = static_cast<RemotePayload*>(payload);
+    bool receiving = stats->received_objects < stats->total_objects;
+    bool last = !receiving && stats->indexed_deltas == stats->total_deltas;
+    if (!remote->shouldReport(last)) return 0;
+
+    if (receiving || stats->total_deltas == 0) {
+        int percent = stats->total_objects ? int(stats->received_objects * 100 / stats->total_objects) : 0;
+        remote->progress(percent, QString("Receiving objects %1/%2, %3")
+            .arg(stats->received_objects).arg(stats->total_objects)
+            .arg(remote->throughput(stats->received_bytes)));
+    } else {
+        remote->progress(int(stats->indexed_deltas * 100 / stats->total_deltas),
+            QString("Resolving deltas %1/%2").arg(stats->indexed_deltas).arg(stats->total_deltas));
+    }
+    return 0;
+}
+
+static int push_transfer_progress_callback(unsigned int current, unsigned int total,
+                                           size_t bytes, void* payload)
+{
+    RemotePayload* remote = static_cast<RemotePayload*>(payload);
+    if (!remote->shouldReport(current == total)) return 0;
+
+    int percent = total ? int(quint64(current) * 100 / total) : 0;
+    remote->progress(percent, QString("Writing objects %1/%2, %3")
+        .arg(current).arg(total).arg(remote->throughput(bytes)));
+    return 0;
+}
+
+// Hook auth and progress callbacks up to `payload`
+static void setRemoteCallbacks(git_remote_callbacks* callbacks, RemotePayload* payload)
+{
+    callbacks->credentials = credentials_callback;
+    callbacks->certificate_check = certificate_check_callback;
+    callbacks->payload = payload;
+    if (payload->progress) {
+        callbacks->transfer_progress = transfer_progress_callback;
+        callbacks->push_transfer_progress = push_transfer_progress_callback;
+        payload->clock.start();
+    }
+}
+
+// Speculative requests kept at once, the oldest are dropped first
+static const int MAX_PREFETCH_QUEUE = 8;
+
+// Repository open options, shared by every GitRepo
+struct GitOpenOptions {
+    QByteArray ceilingDirs;             // GIT_PATH_LIST_SEPARATOR-joined
+    bool directGitDir = true;
+};
+
+static GitOpenOptions s_openOptions;
+static QMutex s_openOptionsMutex;        // options may change while tasks run
+
 // RAII wrapper for git_repository
 class GitRepo {
 public:
@@ -92,13 +239,46 @@ public:
     ~GitRepo() { if (repo) git_repository_free(repo); }
 
     bool open(const QString& path) {
-        return git_repository_open(&repo, path.toUtf8().constData()) == 0;
+        GitOpenOptions options;
+        {
+            QMutexLocker locker(&s_openOptionsMutex);
+            options = s_openOptions;
+        }
+
+        // Discovery already resolved the git dir: open it as is, without
+        // probing path/.git, parent directories or the environment
+        if (options.directGitDir) {
+            GitDirInfo info = RefReader::resolveGitDir(path);
+            if (info.isValid() &&
+                git_repository_open_ext(&repo, info.gitDir.toUtf8().constData(),
+                                        GIT_REPOSITORY_OPEN_NO_SEARCH | GIT_REPOSITORY_OPEN_NO_DOTGIT,
+                                        nullptr) == 0) {
+                return true;
+            }
+        }
+
+        // Fallback: no upward search, unless ceilings bound it
+        const char* ceilings = options.ceilingDirs.isEmpty()
+            ? nullptr : options.ceilingDirs.constData();
+        unsigned int flags = ceilings ? 0 : GIT_REPOSITORY_OPEN_NO_SEARCH;
+        return git_repository_open_ext(&repo, path.toUtf8().constData(), flags, ceilings) == 0;
     }
 
     operator git_repository*() { return repo; }
     git_repository* get() { return repo; }
 };
 
+void GitWorker::setOpenOptions(const QStringList& ceilingDirs, bool directGitDirOpen)
+{
+    QStringList cleaned;
+    for (const QString& dir : ceilingDirs) {
+        cleaned.append(QDir::cleanPath(QDir::fromNativeSeparators(dir)));
+    }
+    QMutexLocker locker(&s_openOptionsMutex);
+    s_openOptions.ceilingDirs = cleaned.join(QLatin1Char(GIT_PATH_LIST_SEPARATOR)).toUtf8();
+    s_openOptions.directGitDir = directGitDirOpen;
+}
+
 // RAII wrapper for git_reference
 class GitRef {
 public:
@@ -207,9 +387,128 @@ public:
     git_tree** ptr() { return &tree; }
 };
 
+// RAII wrapper for git_revwalk
+class GitRevwalk {
+public:
+    git_revwalk* walk = nullptr;
+
+    GitRevwalk() = default;
+    ~GitRevwalk() { if (walk) git_revwalk_free(walk); }
+
+    operator git_revwalk*() { return walk; }
+    git_revwalk** ptr() { return &walk; }
+};
+
+// RAII wrapper for git_config
+class GitConfig {
+public:
+    git_config* config = nullptr;
+
+    GitConfig() = default;
+    ~GitConfig() { if (config) git_config_free(config); }
+
+    operator git_config*() { return config; }
+    git_config** ptr() { return &config; }
+};
+
+static QByteArray oidBytes(const git_oid* oid)
+{
+    return QByteArray(reinterpret_cast<const char*>(oid->id), GIT_OID_RAWSZ);
+}
+
+// Count commits reachable from `from` but from none of the hidden commits
+static bool countExclusive(git_repository* repo, const git_oid* from,
+                           const git_oid* hide1, const git_oid* hide2, size_t* out)
+{
+    GitRevwalk walk;
+    if (git_revwalk_new(walk.ptr(), repo) != 0) return false;
+    if (git_revwalk_push(walk, from) != 0) return false;
+    if (hide1 && git_revwalk_hide(walk, hide1) != 0) return false;
+    if (hide2 && git_revwalk_hide(walk, hide2) != 0) return false;
+
+    size_t count = 0;
+    git_oid oid;
+    while (git_revwalk_next(&oid, walk) == 0) {
+        count++;
+    }
+    *out = count;
+    return true;
+}
+
+// One side of the pair moved forward from `oldTip` to `newTip`. Only the new
+// commits are walked: those not reachable from `other` grow this side's
+// exclusive count, the rest were already counted on the other side.
+static bool advanceAheadBehind(git_repository* repo, const git_oid* oldTip, const git_oid* newTip,
+                               const git_oid* other, int* grownSide, int* otherSide)
+{
+    if (git_graph_descendant_of(repo, newTip, oldTip) != 1) return false;
+
+    size_t added = 0, addedExclusive = 0;
+    if (!countExclusive(repo, newTip, oldTip, nullptr, &added)) return false;
+    if (!countExclusive(repo, newTip, oldTip, other, &addedExclusive)) return false;
+
+    *grownSide += static_cast<int>(addedExclusive);
+    *otherSide -= static_cast<int>(added - addedExclusive);
+    return true;
+}
+
+// Ahead/behind memoized per repo by (local, upstream) across sweeps
+static void computeAheadBehind(StatusCache& cache, git_repository* repo, const QString& repoPath,
+                               const git_oid* local, const git_oid* upstream, int* ahead, int* behind)
+{
+    AheadBehind value;
+    value.localOid = oidBytes(local);
+    value.upstreamOid = oidBytes(upstream);
+
+    AheadBehind prev;
+    bool havePrev = cache.lookupAheadBehind(repoPath, &prev);
+
+    if (havePrev && prev.localOid == value.localOid && prev.upstreamOid == value.upstreamOid) {
+        *ahead = prev.ahead;
+        *behind = prev.behind;
+        return;
+    }
+
+    bool done = false;
+    if (havePrev) {
+        value.ahead = prev.ahead;
+        value.behind = prev.behind;
+
+        git_oid prevLocal, prevUpstream;
+        git_oid_fromraw(&prevLocal, reinterpret_cast<const unsigned char*>(prev.localOid.constData()));
+        git_oid_fromraw(&prevUpstream, reinterpret_cast<const unsigned char*>(prev.upstreamOid.constData()));
+
+        if (prev.localOid == value.localOid) {
+            // Upstream advanced (fetch)
+            done = advanceAheadBehind(repo, &prevUpstream, upstream, local, &value.behind, &value.ahead);
+        } else if (prev.upstreamOid == value.upstreamOid) {
+            // Local advanced (commit, fast-forward)
+            done = advanceAheadBehind(repo, &prevLocal, local, upstream, &value.ahead, &value.behind);
+        }
+    }
+
+    if (!done) {
+        // Rewritten history or first sight: full walk
+        size_t a = 0, b = 0;
+        if (git_graph_ahead_behind(&a, &b, repo, local, upstream) != 0) {
+            *ahead = 0;
+            *behind = 0;
+            return;
+        }
+        value.ahead = static_cast<int>(a);
+        value.behind = static_cast<int>(b);
+    }
+
+    cache.storeAheadBehind(repoPath, value);
+    *ahead = value.ahead;
+    *behind = value.behind;
+}
+
 GitWorker::GitWorker(QObject *parent)
     : QThread(parent)
     , m_running(true)
+    , m_concurrency(0)
+    , m_submoduleRows(false)
 {
     qRegisterMetaType<GitTaskRequest>("GitTaskRequest");
     qRegisterMetaType<GitTaskResult>("GitTaskResult");
@@ -224,6 +523,25 @@ GitWorker::~GitWorker()
     git_libgit2_shutdown();
 }
 
+void GitWorker::setConcurrency(int concurrency)
+{
+    m_concurrency = concurrency;
+}
+
+int GitWorker::threadCount() const
+{
+    int concurrency = m_concurrency;
+    return concurrency > 0 ? concurrency : QThread::idealThreadCount();
+}
+
+void GitWorker::setSubmoduleRows(bool submoduleRows)
+{
+    // Snapshots taken the other way cover the wrong set of workdirs
+    if (m_submoduleRows.exchange(submoduleRows) != submoduleRows) {
+        m_statusCache.clear();
+    }
+}
+
 void GitWorker::stopWorker()
 {
     QMutexLocker locker(&m_queueMutex);
@@ -234,10 +552,29 @@ void GitWorker::stopWorker()
 void GitWorker::queueTask(GitTaskRequest request)
 {
     QMutexLocker locker(&m_queueMutex);
-    m_taskQueue.enqueue(request);
+    if (request.prefetch) {
+        // Same repo and task already waiting: keep the older one
+        for (const GitTaskRequest& queued : m_prefetchQueue) {
+            if (queued.task == request.task && queued.repoPath == request.repoPath) {
+                return;
+            }
+        }
+        if (m_prefetchQueue.size() >= MAX_PREFETCH_QUEUE) {
+            m_prefetchQueue.dequeue();
+        }
+        m_prefetchQueue.enqueue(request);
+    } else {
+        m_taskQueue.enqueue(request);
+    }
     m_queueCondition.wakeOne();
 }
 
+void GitWorker::clearPrefetchQueue()
+{
+    QMutexLocker locker(&m_queueMutex);
+    m_prefetchQueue.clear();
+}
+
 void GitWorker::cancelTask(int requestId)
 {
     QMutexLocker locker(&m_queueMutex);
@@ -258,12 +595,12 @@ void GitWorker::run()
 
         {
             QMutexLocker locker(&m_queueMutex);
-            while (m_taskQueue.isEmpty() && m_running) {
+            while (m_taskQueue.isEmpty() && m_prefetchQueue.isEmpty() && m_running) {
                 m_queueCondition.wait(&m_queueMutex);
             }
 
             if (!m_running) break;
-            request = m_taskQueue.dequeue();
+            request = !m_taskQueue.isEmpty() ? m_taskQueue.dequeue() : m_prefetchQueue.dequeue();
         }
 
         GitTaskResult result;
@@ -321,10 +658,24 @@ void GitWorker::run()
             case GitTask::GetDiff:
                 result = handleGetDiff(request);
                 break;
+            case GitTask::PullAllClean:
+                result = handlePullAllClean(request);
+                break;
+            case GitTask::PushAll:
+                result = handlePushAll(request);
+                break;
+            case GitTask::MergeAll:
+                result = handleMergeAll(request);
+                break;
         }
 
         result.task = request.task;
-        emit taskCompleted(result);
+        result.repoPath = request.repoPath;
+        if (request.prefetch) {
+            emit prefetchCompleted(result);
+        } else {
+            emit taskCompleted(result);
+        }
     }
 }
 
@@ -337,20 +688,17 @@ QString GitWorker::getLastError()
     return "Unknown error";
 }
 
-QString GitWorker::getCurrentBranch(const QString& repoPath)
+std::function<void(int, const QString&)> GitWorker::progressReporter(int requestId)
 {
-    GitRepo repo;
-    if (!repo.open(repoPath)) return QString();
-
-    GitRef head;
-    if (git_repository_head(head.ptr(), repo) != 0) return QString();
-
-    const char* name = nullptr;
-    if (git_branch_name(&name, head) == 0) {
-        return QString::fromUtf8(name);
-    }
+    return [this, requestId](int percent, const QString& status) {
+        emit progressUpdate(requestId, percent, status);
+    };
+}
 
-    return QString();
+QString GitWorker::getCurrentBranch(const QString& repoPath)
+{
+    // Read HEAD directly, no repository open needed
+    return RefReader::currentBranch(repoPath).valueOr(QString());
 }
 
 int GitWorker::getStashCount(const QString& repoPath)
@@ -367,19 +715,375 @@ int GitWorker::getStashCount(const QString& repoPath)
     return count;
 }
 
+// Record every directory from a relative path up to the workdir root
+static void addDirChain(const QString& workdir, QString dir, QHash<QString, FileStamp>* dirs)
+{
+    while (true) {
+        if (dirs->contains(dir)) return;
+        FileStamp stamp;
+        statPath(dir.isEmpty() ? workdir : workdir + QLatin1Char('/') + dir, &stamp);
+        dirs->insert(dir, stamp);
+        if (dir.isEmpty()) return;
+        int slash = dir.lastIndexOf(QLatin1Char('/'));
+        dir = slash < 0 ? QString() : dir.left(slash);
+    }
+}
+
+// First half of a workdir snapshot, taken before the status list it will
+// vouch for: HEAD, the git files and every tracked file and its directories.
+// A change made while libgit2 runs then shows up as a stale stamp.
+static void snapshotTracked(const QString& repoPath, git_repository* repo,
+                            WorkdirSnapshot* snapshot)
+{
+    QString workdir = QDir::cleanPath(QString::fromUtf8(git_repository_workdir(repo)));
+    snapshot->gitDir = QDir::cleanPath(QString::fromUtf8(git_repository_path(repo)));
+
+    // reset --soft and commit --amend move HEAD without touching the index
+    snapshot->headRef = RefReader::currentBranch(repoPath).valueOr(QString());
+    snapshot->headOid = RefReader::headOid(repoPath);
+    statPath(QDir(snapshot->gitDir).filePath("index"), &snapshot->index);
+    statPath(QDir(snapshot->gitDir).filePath("info/exclude"), &snapshot->excludes);
+
+    // core.excludesFile, by default $XDG_CONFIG_HOME/git/ignore
+    GitConfig config;
+    git_buf buf = GIT_BUF_INIT;
+    if (git_repository_config_snapshot(config.ptr(), repo) == 0 &&
+        git_config_get_path(&buf, config, "core.excludesfile") == 0) {
+        snapshot->excludesFile = QString::fromUtf8(buf.ptr, static_cast<qsizetype>(buf.size));
+    } else {
+        QByteArray xdg = qgetenv("XDG_CONFIG_HOME");
+        QString xdgConfig = xdg.isEmpty() ? QDir(QDir::homePath()).filePath(".config")
+                                          : QFile::decodeName(xdg);
+        snapshot->excludesFile = QDir(xdgConfig).filePath("git/ignore");
+    }
+    git_buf_dispose(&buf);
+    statPath(snapshot->excludesFile, &snapshot->globalExcludes);
+
+    GitIndex index;
+    if (git_repository_index(index.ptr(), repo) == 0) {
+        size_t count = git_index_entrycount(index);
+        snapshot->files.reserve(static_cast<int>(count));
+        for (size_t i = 0; i < count; i++) {
+            const git_index_entry* entry = git_index_get_byindex(index, i);
+            // Submodules are directories with their own status
+            if (entry->mode == GIT_FILEMODE_COMMIT) continue;
+
+            QString path = QString::fromUtf8(entry->path);
+            FileStamp stamp;
+            statPath(workdir + QLatin1Char('/') + path, &stamp);
+            snapshot->files.insert(path, stamp);
+
+            int slash = path.lastIndexOf(QLatin1Char('/'));
+            addDirChain(workdir, slash < 0 ? QString() : path.left(slash), &snapshot->dirs);
+        }
+    }
+    addDirChain(workdir, QString(), &snapshot->dirs);
+}
+
+// Directories the status walk enters below `dir` ("" or "a/b"), the way
+// git's untracked cache records them: a new file shows up in the mtime of
+// its directory, be it empty, holding only ignored files or reported
+// collapsed. Ignored directories and nested repositories are not entered.
+// Untracked .gitignore files are stamped like tracked files, an edit to
+// one changes what status reports without touching its directory.
+static void stampVisitedDirs(git_repository* repo, const QString& workdir, const QString& dir,
+                             qint64 sinceNs, WorkdirSnapshot* snapshot)
+{
+    QString abs = dir.isEmpty() ? workdir : workdir + QLatin1Char('/') + dir;
+    if (!snapshot->dirs.contains(dir)) {
+        FileStamp stamp;
+        statPath(abs, &stamp);
+        if (stamp.mtimeNs >= sinceNs) {
+            stamp.mtimeNs = -1;
+        }
+        snapshot->dirs.insert(dir, stamp);
+    }
+
+    QString prefix = dir.isEmpty() ? QString() : dir + QLatin1Char('/');
+    const QFileInfoList entries = QDir(abs)
+        .entryInfoList(QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+    for (const QFileInfo& info : entries) {
+        QString path = prefix + info.fileName();
+        if (!info.isDir() || info.isSymLink()) {
+            if (info.fileName() == QLatin1String(".gitignore") && !snapshot->files.contains(path)) {
+                FileStamp stamp;
+                statPath(info.filePath(), &stamp);
+                if (stamp.mtimeNs >= sinceNs) {
+                    stamp.mtimeNs = -1;
+                }
+                snapshot->files.insert(path, stamp);
+            }
+            continue;
+        }
+        if (info.fileName() == QLatin1String(".git")) continue;
+        // Submodules and nested repositories have a status of their own
+        if (QFileInfo::exists(info.filePath() + QStringLiteral("/.git"))) continue;
+
+        int ignored = 0;
+        QByteArray candidate = (path + QLatin1Char('/')).toUtf8();
+        if (git_ignore_path_is_ignored(&ignored, repo, candidate.constData()) == 0 && ignored) {
+            continue;
+        }
+        stampVisitedDirs(repo, workdir, path, sinceNs, snapshot);
+    }
+}
+
+// Second half of a workdir snapshot, taken once the status list exists.
+// A directory modified since `sinceNs` may have changed after libgit2 read
+// it, so it is recorded with a stamp that never matches.
+static void snapshotUntracked(git_repository* repo, qint64 sinceNs, WorkdirSnapshot* snapshot)
+{
+    QString workdir = QDir::cleanPath(QString::fromUtf8(git_repository_workdir(repo)));
+    stampVisitedDirs(repo, workdir, QString(), sinceNs, snapshot);
+}
+
+// Directory below an untracked one holds something git status would show:
+// a file that is not ignored, or a nested repository
+static bool hasUntrackedContent(git_repository* repo, const QString& workdir, const QString& dir)
+{
+    const QFileInfoList entries = QDir(workdir + QLatin1Char('/') + dir)
+        .entryInfoList(QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+    for (const QFileInfo& info : entries) {
+        if (info.fileName() == QLatin1String(".git")) return true;
+        bool isDir = info.isDir() && !info.isSymLink();
+        QString path = dir + info.fileName() + (isDir ? QStringLiteral("/") : QString());
+        int ignored = 0;
+        if (git_ignore_path_is_ignored(&ignored, repo, path.toUtf8().constData()) == 0 && ignored) {
+            continue;
+        }
+        if (!isDir || hasUntrackedContent(repo, workdir, path)) return true;
+    }
+    return false;
+}
+
+// First untracked entry below `dir` ("" or "a/b/") as git status lists it,
+// a file or a collapsed directory ("a/c/"). Only the directories holding
+// tracked files are listed; the stat of tracked files is left to the
+// caller, which already knows they match the index.
+static bool findUntracked(git_repository* repo, const QString& workdir, const QString& dir,
+                          const QSet<QString>& files, const QSet<QString>& dirs, QString* found)
+{
+    const QFileInfoList entries = QDir(workdir + QLatin1Char('/') + dir)
+        .entryInfoList(QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+    for (const QFileInfo& info : entries) {
+        if (info.fileName() == QLatin1String(".git")) continue;
+        QString path = dir + info.fileName();
+        // Tracked file, symlink or submodule
+        if (files.contains(path)) continue;
+
+        bool isDir = info.isDir() && !info.isSymLink();
+        if (isDir && dirs.contains(path)) {
+            if (findUntracked(repo, workdir, path + QLatin1Char('/'), files, dirs, found)) return true;
+            continue;
+        }
+
+        QString candidate = isDir ? path + QLatin1Char('/') : path;
+        int ignored = 0;
+        if (git_ignore_path_is_ignored(&ignored, repo, candidate.toUtf8().constData()) == 0 && ignored) {
+            continue;
+        }
+        if (!isDir || hasUntrackedContent(repo, workdir, candidate)) {
+            *found = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Untracked check for a workdir whose tracked files all match the index
+static bool firstUntracked(git_repository* repo, QString* found)
+{
+    GitIndex index;
+    if (git_repository_index(index.ptr(), repo) != 0) return false;
+
+    QSet<QString> files;
+    QSet<QString> dirs;
+    size_t count = git_index_entrycount(index);
+    files.reserve(static_cast<int>(count));
+    for (size_t i = 0; i < count; i++) {
+        QString path = QString::fromUtf8(git_index_get_byindex(index, i)->path);
+        files.insert(path);
+        for (int slash = path.lastIndexOf(QLatin1Char('/')); slash > 0;
+             slash = path.lastIndexOf(QLatin1Char('/'), slash - 1)) {
+            if (dirs.contains(path.left(slash))) break;
+            dirs.insert(path.left(slash));
+        }
+    }
+
+    QString workdir = QDir::cleanPath(QString::fromUtf8(git_repository_workdir(repo)));
+    return findUntracked(repo, workdir, QString(), files, dirs, found);
+}
+
+// Wall clock as file timestamps use it, one second early to allow for
+// coarse filesystem clocks
+static qint64 racyCutoffNs()
+{
+    return (QDateTime::currentMSecsSinceEpoch() - 1000) * qint64(1000000);
+}
+
+// Submodules are status-checked as repositories of their own. For the parent
+// only their recorded commit matters: staged (index vs HEAD) or moved
+// (checkout vs index). Checked-out commits are returned for the snapshot.
+static bool gitlinksChanged(git_repository* repo, QHash<QString, QByteArray>* heads)
+{
+    GitIndex index;
+    if (git_repository_index(index.ptr(), repo) != 0) return false;
+
+    GitObject headTree;
+    bool hasHead = git_revparse_single(headTree.ptr(), repo, "HEAD^{tree}") == 0;
+    QString workdir = QDir::cleanPath(QString::fromUtf8(git_repository_workdir(repo)));
+
+    bool changed = false;
+    size_t count = git_index_entrycount(index);
+    for (size_t i = 0; i < count; i++) {
+        const git_index_entry* entry = git_index_get_byindex(index, i);
+        if (entry->mode != GIT_FILEMODE_COMMIT) continue;
+
+        git_tree_entry* recorded = nullptr;
+        if (!hasHead ||
+            git_tree_entry_bypath(&recorded, reinterpret_cast<git_tree*>(headTree.obj), entry->path) != 0 ||
+            !git_oid_equal(git_tree_entry_id(recorded), &entry->id)) {
+            changed = true;
+        }
+        git_tree_entry_free(recorded);
+
+        // Not checked out (no HEAD) is not a change, as with git status
+        QString path = QString::fromUtf8(entry->path);
+        QByteArray checkedOut = RefReader::headOid(workdir + QLatin1Char('/') + path);
+        char hex[GIT_OID_HEXSZ + 1];
+        git_oid_tostr(hex, sizeof(hex), &entry->id);
+        if (!checkedOut.isEmpty() && checkedOut != QByteArray(hex)) {
+            changed = true;
+        }
+        heads->insert(path, checkedOut);
+    }
+    return changed;
+}
+
+// Local changes inside the given submodule workdirs, for parents that do
+// not list their submodules as repositories of their own
+static bool submodulesModified(git_repository* repo, const QStringList& paths)
+{
+    QList<QByteArray> raw;
+    std::vector<char*> strings;
+    raw.reserve(paths.size());
+    for (const QString& path : paths) {
+        raw.append(path.toUtf8());
+        strings.push_back(raw.last().data());
+    }
+
+    git_status_options opts = GIT_STATUS_OPTIONS_INIT;
+    opts.show = GIT_STATUS_SHOW_WORKDIR_ONLY;
+    opts.flags = GIT_STATUS_OPT_DISABLE_PATHSPEC_MATCH;
+    opts.pathspec.strings = strings.data();
+    opts.pathspec.count = strings.size();
+
+    GitStatusList status;
+    return git_status_list_new(status.ptr(), repo, &opts) == 0 &&
+           git_status_list_entrycount(status) > 0;
+}
+
+// Stamps of what GetBranches/GetChanges results depend on, read without libgit2
+static ResultStamp resultStamp(const QString& repoPath)
+{
+    ResultStamp stamp;
+    stamp.headRef = RefReader::currentBranch(repoPath).valueOr(QString());
+    stamp.headOid = RefReader::headOid(repoPath);
+    stamp.refsGeneration = RefReader::branchesGeneration(repoPath);
+    GitDirInfo dirs = RefReader::resolveGitDir(repoPath);
+    if (dirs.isValid()) {
+        statPath(QDir(dirs.gitDir).filePath("index"), &stamp.index);
+    }
+    return stamp;
+}
+
 bool GitWorker::hasUncommittedChanges(const QString& repoPath)
 {
+    // Unchanged since the last full check: skip libgit2 entirely
+    bool needsCommit = false;
+    if (m_statusCache.lookupNeedsCommit(repoPath, &needsCommit)) {
+        return needsCommit;
+    }
+
+    quint64 generation = m_statusCache.generation(repoPath);
+
     GitRepo repo;
     if (!repo.open(repoPath)) return false;
 
+    bool bare = git_repository_is_bare(repo);
+    WorkdirSnapshot snapshot;
+    qint64 cutoffNs = racyCutoffNs();
+    if (!bare) {
+        snapshotTracked(repoPath, repo, &snapshot);
+    }
+
+    // Stat-only pass over the tracked files. Anything short of Clean or
+    // Dirty (timestamps moved, unusual index) needs libgit2's compare.
+    IndexReader::Scan scan = IndexReader::Unsupported;
+    IndexReader index;
+    if (!bare && index.open(repoPath)) {
+        scan = index.scan(repoPath);
+    }
+
+    // Submodules listed as repositories of their own are checked there,
+    // see gitlinksChanged; otherwise their workdirs count here, as with git
     git_status_options opts = GIT_STATUS_OPTIONS_INIT;
-    opts.show = GIT_STATUS_SHOW_INDEX_AND_WORKDIR;
-    opts.flags = GIT_STATUS_OPT_INCLUDE_UNTRACKED;
+    if (m_submoduleRows) {
+        opts.flags = GIT_STATUS_OPT_EXCLUDE_SUBMODULES;
+    }
+    QHash<QString, QByteArray> submoduleHeads;
+
+    if (scan == IndexReader::Dirty) {
+        // A tracked file gone, resized or unmerged settles it. The snapshot
+        // holds until that file or the index changes, untracked files
+        // cannot turn the answer back.
+        needsCommit = true;
+    } else if (scan == IndexReader::Clean) {
+        // Tracked files match the index: what is left are staged changes
+        // (HEAD against index, no workdir access) and untracked files
+        opts.show = GIT_STATUS_SHOW_INDEX_ONLY;
+        GitStatusList staged;
+        if (git_status_list_new(staged.ptr(), repo, &opts) != 0) return false;
+        needsCommit = git_status_list_entrycount(staged) > 0;
+        if (gitlinksChanged(repo, &submoduleHeads)) {
+            needsCommit = true;
+        }
+        if (!needsCommit && !m_submoduleRows && !submoduleHeads.isEmpty() &&
+            submodulesModified(repo, submoduleHeads.keys())) {
+            needsCommit = true;
+        }
+        QString found;
+        if (!needsCommit && firstUntracked(repo, &found)) {
+            needsCommit = true;
+        }
+    } else {
+        opts.show = GIT_STATUS_SHOW_INDEX_AND_WORKDIR;
+        opts.flags |= GIT_STATUS_OPT_INCLUDE_UNTRACKED;
+        GitStatusList status;
+        if (git_status_list_new(status.ptr(), repo, &opts) != 0) return false;
+        needsCommit = git_status_list_entrycount(status) > 0;
+        if (!bare && gitlinksChanged(repo, &submoduleHeads)) {
+            needsCommit = true;
+        }
+    }
 
-    GitStatusList status;
-    if (git_status_list_new(status.ptr(), repo, &opts) != 0) return false;
+    if (!bare) {
+        // A Dirty scan holds whatever else appears, no directory to record
+        if (scan != IndexReader::Dirty) {
+            snapshotUntracked(repo, cutoffNs, &snapshot);
+        }
+        snapshot.submodules = submoduleHeads;
+        snapshot.needsCommit = needsCommit;
+        // Edits inside a submodule workdir leave the parent's stamps alone:
+        // an empty snapshot never matches, so the next check runs again
+        if (!m_submoduleRows && !submoduleHeads.isEmpty() && scan != IndexReader::Dirty) {
+            snapshot = WorkdirSnapshot();
+        }
+        m_statusCache.storeSnapshot(repoPath, snapshot, generation);
+        emit snapshotStored(repoPath);
+    }
 
-    return git_status_list_entrycount(status) > 0;
+    return needsCommit;
 }
 
 GitTaskResult GitWorker::handleCheckStatus(const GitTaskRequest& req)
@@ -410,14 +1114,12 @@ GitTaskResult GitWorker::handleCheckStatus(const GitTaskRequest& req)
     if (git_repository_head(head.ptr(), repo) == 0) {
         GitRef upstream;
         if (git_branch_upstream(upstream.ptr(), head) == 0) {
-            size_t a = 0, b = 0;
             const git_oid* local_oid = git_reference_target(head);
             const git_oid* upstream_oid = git_reference_target(upstream);
 
             if (local_oid && upstream_oid) {
-                git_graph_ahead_behind(&a, &b, repo, local_oid, upstream_oid);
-                ahead = static_cast<int>(a);
-                behind = static_cast<int>(b);
+                computeAheadBehind(m_statusCache, repo, req.repoPath,
+                                   local_oid, upstream_oid, &ahead, &behind);
             }
         }
     }
@@ -428,6 +1130,16 @@ GitTaskResult GitWorker::handleCheckStatus(const GitTaskRequest& req)
     statusData["needsPull"] = behind > 0;
     statusData["hasError"] = false;
 
+    // Remembered for bulk tasks (pull all, push all)
+    RepoStatus status;
+    status.currentBranch = branch;
+    status.needsCommit = statusData["needsCommit"].toBool();
+    status.ahead = ahead;
+    status.behind = behind;
+    status.needsPush = ahead > 0;
+    status.needsPull = behind > 0;
+    m_statusCache.storeStatus(req.repoPath, status);
+
     // Wrap with path for consistent handling in MainScreen
     QVariantMap resultData;
     resultData["path"] = req.repoPath;
@@ -447,29 +1159,184 @@ GitTaskResult GitWorker::handleCheckAllStatus(const GitTaskRequest& req)
     int total = req.args.size();
     int current = 0;
 
-    for (const QString& path : req.args) {
-        GitTaskRequest singleReq;
-        singleReq.repoPath = path;
-        singleReq.requestId = req.requestId;
+    // Repositories (submodules included) are independent: check them in
+    // parallel, each job opens its own git_repository
+    QThreadPool pool;
+    pool.setMaxThreadCount(threadCount());
+    QMutex resultsMutex;
 
-        GitTaskResult singleResult = handleCheckStatus(singleReq);
+    for (const QString& path : req.args) {
+        pool.start([&, path]() {
+            GitTaskRequest singleReq;
+            singleReq.repoPath = path;
+            singleReq.requestId = req.requestId;
+
+            GitTaskResult singleResult = handleCheckStatus(singleReq);
+
+            // Same shape as a single CheckStatus result: {path, status}
+            QVariantMap statusData = singleResult.data.toMap().value("status").toMap();
+            if (!singleResult.success) {
+                statusData["hasError"] = true;
+                statusData["errorMessage"] = singleResult.message;
+            }
 
-        QVariantMap repoStatus;
-        repoStatus["path"] = path;
-        repoStatus["status"] = singleResult.data;
-        repoStatus["success"] = singleResult.success;
-        allStatus.append(repoStatus);
+            QVariantMap repoStatus;
+            repoStatus["path"] = path;
+            repoStatus["status"] = statusData;
+            repoStatus["success"] = singleResult.success;
 
-        current++;
-        int percent = (current * 100) / total;
-        emit progressUpdate(req.requestId, percent, QString("Checking %1/%2").arg(current).arg(total));
+            QMutexLocker locker(&resultsMutex);
+            allStatus.append(repoStatus);
+            current++;
+            int percent = (current * 100) / total;
+            emit progressUpdate(req.requestId, percent, QString("Checking %1/%2").arg(current).arg(total));
+        });
     }
+    pool.waitForDone();
 
     result.success = true;
     result.data = allStatus;
     return result;
 }
 
+// git_checkout_options progress, payload is a ProgressFn
+static void checkout_progress_callback(const char* path, size_t completed, size_t total, void* payload)
+{
+    Q_UNUSED(path);
+    if (total == 0) return;
+
+    // libgit2 reports every file, keep one update per percent
+    if (completed > 0 && completed < total &&
+        (completed * 100) / total == ((completed - 1) * 100) / total) {
+        return;
+    }
+    (*static_cast<ProgressFn*>(payload))(int(completed * 100 / total),
+        QString("Checking out %1/%2").arg(completed).arg(total));
+}
+
+// Fetch origin into an already open repository
+static bool fetchOrigin(git_repository* repo, QString* error, const ProgressFn& progress = nullptr)
+{
+    GitRemote remote;
+    if (git_remote_lookup(remote.ptr(), repo, "origin") != 0) {
+        *error = "No origin remote found";
+        return false;
+    }
+
+    git_fetch_options opts = GIT_FETCH_OPTIONS_INIT;
+    RemotePayload payload;
+    payload.progress = progress;
+    setRemoteCallbacks(&opts.callbacks, &payload);
+
+    if (git_remote_fetch(remote, nullptr, &opts, nullptr) != 0) {
+        const git_error* err = git_error_last();
+        *error = err ? QString::fromUtf8(err->message) : QString("Unknown error");
+        return false;
+    }
+    return true;
+}
+
+// Move HEAD's branch to `target` and update the working tree from HEAD's tree
+static bool moveHead(git_repository* repo, git_reference* head, const git_oid* target,
+                     const char* reflog, QString* error, const ProgressFn& progress = nullptr)
+{
+    GitObject targetCommit;
+    if (git_object_lookup(targetCommit.ptr(), repo, target, GIT_OBJECT_COMMIT) != 0) {
+        const git_error* err = git_error_last();
+        *error = err ? QString::fromUtf8(err->message) : QString("Unknown error");
+        return false;
+    }
+
+    // Update the workdir first: a refused checkout leaves the branch untouched
+    git_checkout_options checkout_opts = GIT_CHECKOUT_OPTIONS_INIT;
+    checkout_opts.checkout_strategy = GIT_CHECKOUT_SAFE;
+    if (progress) {
+        checkout_opts.progress_cb = checkout_progress_callback;
+        checkout_opts.progress_payload = const_cast<ProgressFn*>(&progress);
+    }
+    if (git_checkout_tree(repo, targetCommit, &checkout_opts) != 0) {
+        const git_error* err = git_error_last();
+        *error = err ? QString::fromUtf8(err->message) : QString("Unknown error");
+        return false;
+    }
+
+    GitRef new_ref;
+    if (git_reference_set_target(new_ref.ptr(), head, target, reflog) != 0) {
+        const git_error* err = git_error_last();
+        *error = err ? QString::fromUtf8(err->message) : QString("Unknown error");
+        return false;
+    }
+    return true;
+}
+
+// Merge `other` into HEAD. The merge is computed into an in-memory index
+// first; the workdir is only written when that merge is clean, so a
+// conflicting merge reports its paths and leaves the repository untouched.
+static bool mergeIntoHead(git_repository* repo, git_reference* head, const git_oid* other,
+                          const QString& message, QStringList* conflicts, QString* error,
+                          const ProgressFn& progress = nullptr)
+{
+    GitCommit ours;
+    GitCommit theirs;
+    GitIndex merged;
+    git_merge_options merge_opts = GIT_MERGE_OPTIONS_INIT;
+    if (git_commit_lookup(ours.ptr(), repo, git_reference_target(head)) != 0 ||
+        git_commit_lookup(theirs.ptr(), repo, other) != 0 ||
+        git_merge_commits(merged.ptr(), repo, ours, theirs, &merge_opts) != 0) {
+        const git_error* err = git_error_last();
+        *error = err ? QString::fromUtf8(err->message) : QString("Unknown error");
+        return false;
+    }
+
+    if (git_index_has_conflicts(merged)) {
+        git_index_conflict_iterator* it = nullptr;
+        if (git_index_conflict_iterator_new(&it, merged) == 0) {
+            const git_index_entry* ancestor;
+            const git_index_entry* our;
+            const git_index_entry* their;
+            while (git_index_conflict_next(&ancestor, &our, &their, it) == 0) {
+                const git_index_entry* entry = our ? our : (their ? their : ancestor);
+                conflicts->append(QString::fromUtf8(entry->path));
+            }
+            git_index_conflict_iterator_free(it);
+        }
+
+        QStringList shown = conflicts->mid(0, 3);
+        *error = QString("Merge not started, conflicts in %1").arg(shown.join(", "));
+        if (conflicts->size() > shown.size()) {
+            *error += QString(" and %1 more").arg(conflicts->size() - shown.size());
+        }
+        return false;
+    }
+
+    git_oid tree_oid;
+    GitTree tree;
+    if (git_index_write_tree_to(&tree_oid, merged, repo) != 0 ||
+        git_tree_lookup(tree.ptr(), repo, &tree_oid) != 0) {
+        const git_error* err = git_error_last();
+        *error = err ? QString::fromUtf8(err->message) : QString("Unknown error");
+        return false;
+    }
+
+    GitSignature sig;
+    if (git_signature_default(sig.ptr(), repo) != 0) {
+        *error = "Cannot create signature - configure user.name and user.email";
+        return false;
+    }
+
+    // Commit without moving HEAD, moveHead does that after the checkout
+    const git_commit* parents[] = { ours, theirs };
+    git_oid commit_oid;
+    if (git_commit_create(&commit_oid, repo, nullptr, sig, sig, nullptr,
+                          message.toUtf8().constData(), tree, 2, parents) != 0) {
+        const git_error* err = git_error_last();
+        *error = err ? QString::fromUtf8(err->message) : QString("Unknown error");
+        return false;
+    }
+
+    return moveHead(repo, head, &commit_oid, "merge", error, progress);
+}
+
 GitTaskResult GitWorker::handleFetch(const GitTaskRequest& req)
 {
     GitTaskResult result;
@@ -482,23 +1349,9 @@ GitTaskResult GitWorker::handleFetch(const GitTaskRequest& req)
         return result;
     }
 
-    GitRemote remote;
-    if (git_remote_lookup(remote.ptr(), repo, "origin") != 0) {
-        result.success = false;
-        result.message = "No origin remote found";
-        return result;
-    }
-
-    git_fetch_options opts = GIT_FETCH_OPTIONS_INIT;
-    int auth_attempts = 0;
-    opts.callbacks.credentials = credentials_callback;
-    opts.callbacks.certificate_check = certificate_check_callback;
-    opts.callbacks.payload = &auth_attempts;
-
     qDebug() << "Fetching from origin for" << req.repoPath;
-    if (git_remote_fetch(remote, nullptr, &opts, nullptr) != 0) {
+    if (!fetchOrigin(repo, &result.message, progressReporter(req.requestId))) {
         result.success = false;
-        result.message = getLastError();
         qDebug() << "Fetch failed:" << result.message;
         return result;
     }
@@ -583,67 +1436,33 @@ GitTaskResult GitWorker::handlePull(const GitTaskRequest& req)
     }
 
     if (analysis & GIT_MERGE_ANALYSIS_FASTFORWARD) {
-        // Fast-forward
-        GitRef new_ref;
-        git_reference_set_target(new_ref.ptr(), head, upstream_oid, "pull: fast-forward");
-
-        git_checkout_options checkout_opts = GIT_CHECKOUT_OPTIONS_INIT;
-        checkout_opts.checkout_strategy = GIT_CHECKOUT_SAFE;
-        git_checkout_head(repo, &checkout_opts);
-
         git_annotated_commit_free(annotated);
+        if (!moveHead(repo, head, upstream_oid, "pull: fast-forward", &result.message,
+                      progressReporter(req.requestId))) {
+            result.success = false;
+            return result;
+        }
         result.success = true;
         result.message = "Fast-forward merge successful";
         return result;
     }
 
     if (analysis & GIT_MERGE_ANALYSIS_NORMAL) {
-        // Normal merge
-        git_merge_options merge_opts = GIT_MERGE_OPTIONS_INIT;
-        git_checkout_options checkout_opts = GIT_CHECKOUT_OPTIONS_INIT;
-        checkout_opts.checkout_strategy = GIT_CHECKOUT_SAFE;
-
-        if (git_merge(repo, heads, 1, &merge_opts, &checkout_opts) != 0) {
-            git_annotated_commit_free(annotated);
-            result.success = false;
-            result.message = getLastError();
-            return result;
-        }
+        git_annotated_commit_free(annotated);
 
-        // Check for conflicts
-        GitIndex index;
-        git_repository_index(index.ptr(), repo);
-        if (git_index_has_conflicts(index)) {
-            git_annotated_commit_free(annotated);
+        QStringList conflicts;
+        QString msg = QString("Merge branch '%1'").arg(git_reference_shorthand(upstream));
+        if (!mergeIntoHead(repo, head, upstream_oid, msg, &conflicts, &result.message,
+                           progressReporter(req.requestId))) {
             result.success = false;
-            result.message = "Merge conflicts - resolve manually";
+            if (!conflicts.isEmpty()) {
+                QVariantMap data;
+                data["conflicts"] = conflicts;
+                result.data = data;
+            }
             return result;
         }
 
-        // Create merge commit
-        GitSignature sig;
-        git_signature_default(sig.ptr(), repo);
-
-        git_oid tree_oid;
-        git_index_write_tree(&tree_oid, index);
-
-        GitTree tree;
-        git_tree_lookup(tree.ptr(), repo, &tree_oid);
-
-        GitCommit head_commit;
-        git_commit_lookup(head_commit.ptr(), repo, git_reference_target(head));
-
-        GitCommit upstream_commit;
-        git_commit_lookup(upstream_commit.ptr(), repo, upstream_oid);
-
-        const git_commit* parents[] = { head_commit, upstream_commit };
-        git_oid new_commit_oid;
-        git_commit_create(&new_commit_oid, repo, "HEAD", sig, sig,
-                          nullptr, "Merge branch", tree, 2, parents);
-
-        git_repository_state_cleanup(repo);
-        git_annotated_commit_free(annotated);
-
         result.success = true;
         result.message = "Merge successful";
         return result;
@@ -655,31 +1474,21 @@ GitTaskResult GitWorker::handlePull(const GitTaskRequest& req)
     return result;
 }
 
-GitTaskResult GitWorker::handlePush(const GitTaskRequest& req)
+// Push HEAD's branch to the branch of the same name on origin
+static bool pushHead(git_repository* repo, QString* error, const ProgressFn& progress = nullptr)
 {
-    GitTaskResult result;
-    result.requestId = req.requestId;
-
-    GitRepo repo;
-    if (!repo.open(req.repoPath)) {
-        result.success = false;
-        result.message = getLastError();
-        return result;
-    }
-
     GitRemote remote;
     if (git_remote_lookup(remote.ptr(), repo, "origin") != 0) {
-        result.success = false;
-        result.message = "No origin remote found";
-        return result;
+        *error = "No origin remote found";
+        return false;
     }
 
     // Get current branch
     GitRef head;
     if (git_repository_head(head.ptr(), repo) != 0) {
-        result.success = false;
-        result.message = getLastError();
-        return result;
+        const git_error* err = git_error_last();
+        *error = err ? QString::fromUtf8(err->message) : QString("Unknown error");
+        return false;
     }
 
     const char* branch_name = git_reference_shorthand(head);
@@ -689,16 +1498,34 @@ GitTaskResult GitWorker::handlePush(const GitTaskRequest& req)
     git_strarray refspecs = { const_cast<char**>(&refspec_str), 1 };
 
     git_push_options opts = GIT_PUSH_OPTIONS_INIT;
-    int auth_attempts = 0;
-    opts.callbacks.credentials = credentials_callback;
-    opts.callbacks.certificate_check = certificate_check_callback;
-    opts.callbacks.payload = &auth_attempts;
+    RemotePayload payload;
+    payload.progress = progress;
+    setRemoteCallbacks(&opts.callbacks, &payload);
 
     qDebug() << "Pushing" << refspec << "to origin";
     if (git_remote_push(remote, &refspecs, &opts) != 0) {
+        const git_error* err = git_error_last();
+        *error = err ? QString::fromUtf8(err->message) : QString("Unknown error");
+        qDebug() << "Push failed:" << *error;
+        return false;
+    }
+    return true;
+}
+
+GitTaskResult GitWorker::handlePush(const GitTaskRequest& req)
+{
+    GitTaskResult result;
+    result.requestId = req.requestId;
+
+    GitRepo repo;
+    if (!repo.open(req.repoPath)) {
         result.success = false;
         result.message = getLastError();
-        qDebug() << "Push failed:" << result.message;
+        return result;
+    }
+
+    if (!pushHead(repo, &result.message, progressReporter(req.requestId))) {
+        result.success = false;
         return result;
     }
 
@@ -708,6 +1535,175 @@ GitTaskResult GitWorker::handlePush(const GitTaskRequest& req)
     return result;
 }
 
+#ifndef Q_OS_WIN
+// Full stat data so the next status does not rehash the file
+static void fillIndexStat(git_index_entry* entry, const struct stat& st)
+{
+#ifdef Q_OS_MACOS
+    entry->mtime.seconds = static_cast<int32_t>(st.st_mtimespec.tv_sec);
+    entry->mtime.nanoseconds = static_cast<uint32_t>(st.st_mtimespec.tv_nsec);
+    entry->ctime.seconds = static_cast<int32_t>(st.st_ctimespec.tv_sec);
+    entry->ctime.nanoseconds = static_cast<uint32_t>(st.st_ctimespec.tv_nsec);
+#else
+    entry->mtime.seconds = static_cast<int32_t>(st.st_mtim.tv_sec);
+    entry->mtime.nanoseconds = static_cast<uint32_t>(st.st_mtim.tv_nsec);
+    entry->ctime.seconds = static_cast<int32_t>(st.st_ctim.tv_sec);
+    entry->ctime.nanoseconds = static_cast<uint32_t>(st.st_ctim.tv_nsec);
+#endif
+    entry->dev = static_cast<uint32_t>(st.st_dev);
+    entry->ino = static_cast<uint32_t>(st.st_ino);
+    entry->uid = static_cast<uint32_t>(st.st_uid);
+    entry->gid = static_cast<uint32_t>(st.st_gid);
+    entry->file_size = static_cast<uint32_t>(st.st_size);
+}
+#endif
+
+// Below this many files blobs are hashed on the calling thread
+static const int PARALLEL_STAGE_MIN_FILES = 64;
+
+// One selected file, hashed before the index is touched
+struct StagedBlob {
+    const char* path;       // relative, as stored in the index (points into the selection)
+    git_oid oid;
+    bool removed = false;   // gone from the workdir: stage the deletion
+    bool fallback = false;  // left to git_index_add_bypath (dirs, conflicts, errors)
+#ifndef Q_OS_WIN
+    struct stat st;
+#endif
+};
+
+// Hash blobs[begin, end) through `repo`, or mark them for the fallback
+static void hashStagedBlobs(git_repository* repo, const QByteArray& workdir, const Utf8List& files,
+                            QVector<StagedBlob>& blobs, int begin, int end)
+{
+    for (int i = begin; i < end; i++) {
+        StagedBlob& blob = blobs[i];
+        if (blob.fallback) continue;
+        if (!repo) {
+            blob.fallback = true;
+            continue;
+        }
+#ifndef Q_OS_WIN
+        QByteArray abs = workdir;
+        abs.append(files.view(i));
+        if (::lstat(abs.constData(), &blob.st) != 0) {
+            blob.removed = true;
+            continue;
+        }
+        if (!S_ISREG(blob.st.st_mode) && !S_ISLNK(blob.st.st_mode)) {
+            blob.fallback = true;
+            continue;
+        }
+#else
+        QFileInfo info(QString::fromUtf8(workdir) + files.at(i));
+        if (!info.exists() && !info.isSymLink()) {
+            blob.removed = true;
+            continue;
+        }
+        if (info.isDir()) {
+            blob.fallback = true;
+            continue;
+        }
+#endif
+        if (git_blob_create_from_workdir(&blob.oid, repo, blob.path) != 0) {
+            blob.fallback = true;
+        }
+    }
+}
+
+// Stage `files` like a git_index_add_bypath loop that also stages
+// deletions, stopping at the first path that fails. From
+// PARALLEL_STAGE_MIN_FILES on, blobs are hashed and written on `threads`
+// threads, each with its own repository so filters (autocrlf, attributes)
+// apply as usual. The index itself is only touched from the calling
+// thread, then written once by the caller.
+static bool stageFiles(const QString& repoPath, git_repository* repo, git_index* index,
+                       const Utf8List& files, int threads, QString* error)
+{
+    QByteArray workdir(git_repository_workdir(repo));
+    QVector<StagedBlob> blobs(files.size());
+    for (int i = 0; i < files.size(); i++) {
+        blobs[i].path = files.data(i);
+        // Conflicted paths (any of stages 1-3) need the REUC bookkeeping
+        // only add_bypath does
+        const git_index_entry* ancestor = nullptr;
+        const git_index_entry* ours = nullptr;
+        const git_index_entry* theirs = nullptr;
+        blobs[i].fallback = git_index_conflict_get(&ancestor, &ours, &theirs, index, blobs[i].path) == 0;
+    }
+
+    if (files.size() < PARALLEL_STAGE_MIN_FILES) {
+        hashStagedBlobs(repo, workdir, files, blobs, 0, files.size());
+    } else {
+        int chunks = qMin(threads, files.size());
+        QThreadPool pool;
+        pool.setMaxThreadCount(chunks);
+        for (int c = 0; c < chunks; c++) {
+            int begin = (files.size() * c) / chunks;
+            int end = (files.size() * (c + 1)) / chunks;
+            pool.start([&, begin, end]() {
+                GitRepo local;
+                bool opened = local.open(repoPath);
+                hashStagedBlobs(opened ? local.get() : nullptr,
+                                workdir, files, blobs, begin, end);
+            });
+        }
+        pool.waitForDone();
+    }
+
+    int trustFilemode = 1;
+    GitConfig config;
+    if (git_repository_config_snapshot(config.ptr(), repo) == 0) {
+        git_config_get_bool(&trustFilemode, config, "core.filemode");
+    }
+
+    // Single pass over the index, in selection order
+    for (const StagedBlob& blob : blobs) {
+        const char* path = blob.path;
+        int rc;
+        if (blob.fallback) {
+            rc = git_index_add_bypath(index, path);
+        } else if (blob.removed) {
+            rc = git_index_remove_bypath(index, path);
+        } else {
+            git_index_entry entry;
+            memset(&entry, 0, sizeof(entry));
+            entry.path = path;
+            git_oid_cpy(&entry.id, &blob.oid);
+
+            const git_index_entry* existing = git_index_get_bypath(index, path, 0);
+#ifndef Q_OS_WIN
+            const struct stat& st = blob.st;
+            if (S_ISLNK(st.st_mode)) {
+                entry.mode = GIT_FILEMODE_LINK;
+            } else if (!trustFilemode && existing) {
+                entry.mode = existing->mode;
+            } else {
+                entry.mode = (st.st_mode & S_IXUSR) ? GIT_FILEMODE_BLOB_EXECUTABLE : GIT_FILEMODE_BLOB;
+            }
+            fillIndexStat(&entry, st);
+#else
+            entry.mode = existing ? existing->mode : GIT_FILEMODE_BLOB;
+            FileStamp stamp;
+            if (statPath(QString::fromUtf8(workdir + blob.path), &stamp)) {
+                entry.mtime.seconds = static_cast<int32_t>(stamp.mtimeNs / 1000000000);
+                entry.mtime.nanoseconds = static_cast<uint32_t>(stamp.mtimeNs % 1000000000);
+                entry.file_size = static_cast<uint32_t>(stamp.size);
+            }
+#endif
+            rc = git_index_add(index, &entry);
+        }
+
+        if (rc != 0) {
+            const git_error* err = git_error_last();
+            *error = QString("%1: %2").arg(QString::fromUtf8(blob.path),
+                                            err ? QString::fromUtf8(err->message) : QString("Unknown error"));
+            return false;
+        }
+    }
+    return true;
+}
+
 GitTaskResult GitWorker::handleCommit(const GitTaskRequest& req)
 {
     GitTaskResult result;
@@ -720,7 +1716,8 @@ GitTaskResult GitWorker::handleCommit(const GitTaskRequest& req)
     }
 
     QString message = req.args[0];
-    QStringList files = req.args.mid(1);
+    // Paths as GetChanges produced them; plain args from other callers
+    Utf8List files = req.paths.isEmpty() ? Utf8List::fromStringList(req.args.mid(1)) : req.paths;
 
     GitRepo repo;
     if (!repo.open(req.repoPath)) {
@@ -741,8 +1738,10 @@ GitTaskResult GitWorker::handleCommit(const GitTaskRequest& req)
         // Add all
         git_index_add_all(index, nullptr, GIT_INDEX_ADD_DEFAULT, nullptr, nullptr);
     } else {
-        for (const QString& file : files) {
-            git_index_add_bypath(index, file.toUtf8().constData());
+        int threads = threadCount();
+        if (!stageFiles(req.repoPath, repo, index, files, threads, &result.message)) {
+            result.success = false;
+            return result;
         }
     }
 
@@ -800,6 +1799,256 @@ GitTaskResult GitWorker::handleCommit(const GitTaskRequest& req)
     return result;
 }
 
+// Below this many written files git_checkout_tree is faster than the pool
+static const int PARALLEL_CHECKOUT_MIN_FILES = 32;
+
+// One path changed between HEAD and the checkout target
+struct CheckoutWrite {
+    QByteArray path;
+    git_oid oid;
+    git_filemode_t mode = GIT_FILEMODE_UNREADABLE;
+    bool removed = false;       // deleted in the target
+    bool added = false;         // absent from HEAD
+    bool failed = false;
+#ifndef Q_OS_WIN
+    struct stat st;
+#endif
+};
+
+// Paths that differ between two trees. Returns false if one of them
+// needs what only git_checkout_tree does (submodules, symlinks).
+static bool diffTrees(git_repository* repo, git_tree* from, git_tree* to, QVector<CheckoutWrite>* out)
+{
+    GitDiff diff;
+    if (git_diff_tree_to_tree(diff.ptr(), repo, from, to, nullptr) != 0) {
+        return false;
+    }
+
+    size_t count = git_diff_num_deltas(diff);
+    out->reserve(static_cast<int>(count));
+    for (size_t i = 0; i < count; i++) {
+        const git_diff_delta* delta = git_diff_get_delta(diff, i);
+        for (git_filemode_t mode : { delta->old_file.mode, delta->new_file.mode }) {
+            if (mode != GIT_FILEMODE_UNREADABLE && mode != GIT_FILEMODE_BLOB &&
+                mode != GIT_FILEMODE_BLOB_EXECUTABLE) {
+                return false;
+            }
+        }
+
+        CheckoutWrite write;
+        write.path = delta->new_file.path;
+        write.removed = delta->status == GIT_DELTA_DELETED;
+        write.added = delta->status == GIT_DELTA_ADDED;
+        write.mode = static_cast<git_filemode_t>(delta->new_file.mode);
+        git_oid_cpy(&write.oid, &delta->new_file.id);
+        out->append(write);
+    }
+    return true;
+}
+
+// Tracked paths with changes in the workdir or index
+static void dirtyPaths(git_repository* repo, QSet<QString>* tracked)
+{
+    git_status_options opts = GIT_STATUS_OPTIONS_INIT;
+    opts.show = GIT_STATUS_SHOW_INDEX_AND_WORKDIR;
+
+    GitStatusList status;
+    if (git_status_list_new(status.ptr(), repo, &opts) != 0) {
+        return;
+    }
+
+    size_t count = git_status_list_entrycount(status);
+    for (size_t i = 0; i < count; i++) {
+        const git_status_entry* entry = git_status_byindex(status, i);
+        const git_diff_delta* delta = entry->index_to_workdir ? entry->index_to_workdir
+                                                              : entry->head_to_index;
+        if (!delta) continue;
+        tracked->insert(QString::fromUtf8(delta->new_file.path));
+        if (entry->head_to_index) {
+            tracked->insert(QString::fromUtf8(entry->head_to_index->old_file.path));
+        }
+    }
+}
+
+// Untracked or ignored entries the parallel writer would clobber, checked
+// before anything is deleted: whatever is on disk where the target adds a
+// file or where HEAD had none, and any non-directory where the target needs
+// a directory, unless the switch removes that file itself
+static bool collidesWithWorkdir(const QString& workdir, const QVector<CheckoutWrite>& writes)
+{
+    QSet<QByteArray> removed;
+    for (const CheckoutWrite& write : writes) {
+        if (write.removed) removed.insert(write.path);
+    }
+
+    QSet<QByteArray> checkedDirs;
+    for (const CheckoutWrite& write : writes) {
+        if (write.removed) continue;
+        QFileInfo info(workdir + QString::fromUtf8(write.path));
+        bool present = info.exists() || info.isSymLink();
+        if (present && (write.added || info.isDir() || info.isSymLink())) {
+            return true;
+        }
+
+        for (qsizetype slash = write.path.indexOf('/'); slash >= 0;
+             slash = write.path.indexOf('/', slash + 1)) {
+            QByteArray dir = write.path.left(slash);
+            if (checkedDirs.contains(dir)) continue;
+            checkedDirs.insert(dir);
+            QFileInfo parent(workdir + QString::fromUtf8(dir));
+            bool parentPresent = parent.exists() || parent.isSymLink();
+            if (parentPresent && (!parent.isDir() || parent.isSymLink()) && !removed.contains(dir)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Put every path of `writes` back as HEAD has it after a failed parallel
+// checkout. None of them held local changes (or they were stashed) and
+// nothing untracked was in their way, so forcing them loses nothing.
+static void restoreWrites(git_repository* repo, git_tree* headTree, const QVector<CheckoutWrite>& writes)
+{
+    std::vector<char*> paths;
+    paths.reserve(writes.size());
+    for (const CheckoutWrite& write : writes) {
+        paths.push_back(const_cast<char*>(write.path.constData()));
+    }
+
+    git_checkout_options opts = GIT_CHECKOUT_OPTIONS_INIT;
+    opts.checkout_strategy = GIT_CHECKOUT_FORCE | GIT_CHECKOUT_REMOVE_UNTRACKED |
+                             GIT_CHECKOUT_DISABLE_PATHSPEC_MATCH;
+    opts.paths.strings = paths.data();
+    opts.paths.count = paths.size();
+    git_checkout_tree(repo, reinterpret_cast<git_object*>(headTree), &opts);
+}
+
+// Write the target content of `writes` on a thread pool, then update only
+// those index entries. Everything else in the index (staged changes to
+// untouched paths) is left as is, like a SAFE checkout would. On any
+// failure the index is left alone and the touched paths go back to HEAD.
+static bool checkoutParallel(const QString& repoPath, git_repository* repo, git_tree* headTree,
+                             QVector<CheckoutWrite>& writes, int threads,
+                             const std::function<void(int, int)>& progress, QString* error)
+{
+    QString workdir = QString::fromUtf8(git_repository_workdir(repo));
+
+    // Deletions first: a removed file may be where a new directory goes
+    for (const CheckoutWrite& write : writes) {
+        if (!write.removed) continue;
+        QString abs = workdir + QString::fromUtf8(write.path);
+        QFile::remove(abs);
+        QDir dir = QFileInfo(abs).dir();
+        while (dir.absolutePath().length() > workdir.length() &&
+               dir.isEmpty() && dir.rmdir(dir.absolutePath())) {
+            dir.cdUp();
+        }
+    }
+
+    std::atomic<int> done{0};
+    int total = writes.size();
+    int chunks = qMin(threads, total);
+    QThreadPool pool;
+    pool.setMaxThreadCount(qMax(chunks, 1));
+    for (int c = 0; c < chunks; c++) {
+        int begin = (total * c) / chunks;
+        int end = (total * (c + 1)) / chunks;
+        pool.start([&, begin, end]() {
+            GitRepo local;
+            bool opened = local.open(repoPath);
+            for (int i = begin; i < end; i++) {
+                CheckoutWrite& write = writes[i];
+                if (write.removed) {
+                    progress(++done, total);
+                    continue;
+                }
+
+                // Smudge filters (autocrlf, attributes) as git_checkout_tree would
+                git_blob* blob = nullptr;
+                git_buf buf = GIT_BUF_INIT;
+                git_blob_filter_options filterOpts = GIT_BLOB_FILTER_OPTIONS_INIT;
+                write.failed = !opened ||
+                    git_blob_lookup(&blob, local, &write.oid) != 0 ||
+                    git_blob_filter(&buf, blob, write.path.constData(), &filterOpts) != 0;
+
+                QString abs = workdir + QString::fromUtf8(write.path);
+                if (!write.failed) {
+                    QDir().mkpath(QFileInfo(abs).path());
+                    QFile file(abs);
+                    write.failed = !file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+                                   file.write(buf.ptr, static_cast<qint64>(buf.size)) != static_cast<qint64>(buf.size);
+                    file.close();
+                }
+                git_buf_dispose(&buf);
+                git_blob_free(blob);
+
+                if (!write.failed) {
+                    QFile::Permissions perms = QFile::permissions(abs);
+                    QFile::Permissions exec = QFile::ExeOwner | QFile::ExeGroup | QFile::ExeOther;
+                    QFile::setPermissions(abs, write.mode == GIT_FILEMODE_BLOB_EXECUTABLE
+                                               ? perms | exec : perms & ~exec);
+#ifndef Q_OS_WIN
+                    write.failed = ::lstat(QFile::encodeName(abs).constData(), &write.st) != 0;
+#endif
+                }
+                progress(++done, total);
+            }
+        });
+    }
+    pool.waitForDone();
+
+    for (const CheckoutWrite& write : writes) {
+        if (write.failed) {
+            *error = QString("Cannot write %1").arg(QString::fromUtf8(write.path));
+            restoreWrites(repo, headTree, writes);
+            return false;
+        }
+    }
+
+    GitIndex index;
+    if (git_repository_index(index.ptr(), repo) != 0) {
+        const git_error* err = git_error_last();
+        *error = err ? QString::fromUtf8(err->message) : QString("Unknown error");
+        restoreWrites(repo, headTree, writes);
+        return false;
+    }
+
+    for (const CheckoutWrite& write : writes) {
+        int rc;
+        if (write.removed) {
+            rc = git_index_remove_bypath(index, write.path.constData());
+        } else {
+            git_index_entry entry;
+            memset(&entry, 0, sizeof(entry));
+            entry.path = write.path.constData();
+            entry.mode = write.mode;
+            git_oid_cpy(&entry.id, &write.oid);
+#ifndef Q_OS_WIN
+            fillIndexStat(&entry, write.st);
+#endif
+            rc = git_index_add(index, &entry);
+        }
+        if (rc != 0) {
+            const git_error* err = git_error_last();
+            *error = err ? QString::fromUtf8(err->message) : QString("Unknown error");
+            // Drop the half-updated entries before restoring against the index
+            git_index_read(index, true);
+            restoreWrites(repo, headTree, writes);
+            return false;
+        }
+    }
+
+    if (git_index_write(index) != 0) {
+        const git_error* err = git_error_last();
+        *error = err ? QString::fromUtf8(err->message) : QString("Unknown error");
+        git_index_read(index, true);
+        restoreWrites(repo, headTree, writes);
+        return false;
+    }
+    return true;
+}
+
 GitTaskResult GitWorker::handleCheckout(const GitTaskRequest& req)
 {
     GitTaskResult result;
@@ -820,22 +2069,10 @@ GitTaskResult GitWorker::handleCheckout(const GitTaskRequest& req)
         return result;
     }
 
-    // Stash if needed
-    int stashCountBefore = getStashCount(req.repoPath);
-    bool stashCreated = false;
-
-    if (hasUncommittedChanges(req.repoPath)) {
-        GitSignature sig;
-        git_signature_default(sig.ptr(), repo);
-        git_oid stash_oid;
-        if (git_stash_save(&stash_oid, repo, sig, "auto-stash", GIT_STASH_DEFAULT) == 0) {
-            stashCreated = true;
-        }
-    }
-
     // Try to find local branch
     GitRef branch;
     QString localRef = QString("refs/heads/%1").arg(branchName);
+    bool stashCreated = false;
 
     if (git_reference_lookup(branch.ptr(), repo, localRef.toUtf8().constData()) != 0) {
         // Try to create from remote
@@ -849,31 +2086,98 @@ GitTaskResult GitWorker::handleCheckout(const GitTaskRequest& req)
 
             git_branch_create(branch.ptr(), repo, branchName.toUtf8().constData(), commit, 0);
 
-            // Set upstream
-            git_branch_set_upstream(branch, QString("origin/%1").arg(branchName).toUtf8().constData());
-        } else {
-            if (stashCreated) {
-                git_stash_pop(repo, 0, nullptr);
-            }
-            result.success = false;
-            result.message = QString("Branch '%1' not found").arg(branchName);
-            return result;
+            // Set upstream
+            git_branch_set_upstream(branch, QString("origin/%1").arg(branchName).toUtf8().constData());
+        } else {
+            result.success = false;
+            result.message = QString("Branch '%1' not found").arg(branchName);
+            return result;
+        }
+    }
+
+    // Checkout
+    GitObject target;
+    git_reference_peel(target.ptr(), branch, GIT_OBJECT_COMMIT);
+
+    // Paths the switch touches, compared against dirty files below
+    GitRef head;
+    GitCommit headCommit;
+    GitTree headTree;
+    GitTree targetTree;
+    QVector<CheckoutWrite> writes;
+    bool canParallel = git_repository_head(head.ptr(), repo) == 0 &&
+        git_commit_lookup(headCommit.ptr(), repo, git_reference_target(head)) == 0 &&
+        git_commit_tree(headTree.ptr(), headCommit) == 0 &&
+        git_commit_tree(targetTree.ptr(), reinterpret_cast<git_commit*>(target.obj)) == 0 &&
+        diffTrees(repo, headTree, targetTree, &writes);
+
+    QSet<QString> dirty;
+    dirtyPaths(repo, &dirty);
+
+    bool overlapsDirty = !canParallel;
+    for (const CheckoutWrite& write : writes) {
+        if (dirty.contains(QString::fromUtf8(write.path))) {
+            overlapsDirty = true;
+            break;
+        }
+    }
+
+    // File/directory clashes with untracked or ignored entries, before any
+    // deletion; libgit2 reports them instead of overwriting
+    bool collides = !canParallel ||
+        collidesWithWorkdir(QString::fromUtf8(git_repository_workdir(repo)), writes);
+
+    // Stash only when the switch would touch a modified file
+    int stashCountBefore = getStashCount(req.repoPath);
+    if (!dirty.isEmpty() && overlapsDirty) {
+        GitSignature sig;
+        git_signature_default(sig.ptr(), repo);
+        git_oid stash_oid;
+        if (git_stash_save(&stash_oid, repo, sig, "auto-stash", GIT_STASH_DEFAULT) == 0) {
+            stashCreated = true;
+        }
+    }
+
+    auto progress = [this, &req](int done, int total) {
+        // At most one update per percent from the writer threads
+        if (total > 0 && (done * 100) / total != ((done - 1) * 100) / total) {
+            emit progressUpdate(req.requestId, (done * 100) / total,
+                                QString("Checking out %1/%2").arg(done).arg(total));
         }
+    };
+
+    int writeCount = 0;
+    for (const CheckoutWrite& write : writes) {
+        if (!write.removed) writeCount++;
     }
 
-    // Checkout
-    GitObject target;
-    git_reference_peel(target.ptr(), branch, GIT_OBJECT_COMMIT);
+    // The parallel writer overwrites whatever is on disk, so it is only safe
+    // when no modified file is in the way or those were stashed. Otherwise
+    // the safe libgit2 checkout refuses to clobber them and reports why.
+    bool dirtySafe = dirty.isEmpty() || !overlapsDirty || stashCreated;
 
-    git_checkout_options opts = GIT_CHECKOUT_OPTIONS_INIT;
-    opts.checkout_strategy = GIT_CHECKOUT_SAFE;
+    int rc;
+    QString checkoutError;
+    if (canParallel && dirtySafe && !collides && writeCount >= PARALLEL_CHECKOUT_MIN_FILES) {
+        int threads = threadCount();
+        rc = checkoutParallel(req.repoPath, repo, headTree, writes, threads, progress,
+                              &checkoutError) ? 0 : -1;
+    } else {
+        git_checkout_options opts = GIT_CHECKOUT_OPTIONS_INIT;
+        opts.checkout_strategy = GIT_CHECKOUT_SAFE;
+        ProgressFn reporter = progressReporter(req.requestId);
+        opts.progress_cb = checkout_progress_callback;
+        opts.progress_payload = &reporter;
+        rc = git_checkout_tree(repo, target, &opts);
+        if (rc != 0) checkoutError = getLastError();
+    }
 
-    if (git_checkout_tree(repo, target, &opts) != 0) {
+    if (rc != 0) {
         if (stashCreated) {
             git_stash_pop(repo, 0, nullptr);
         }
         result.success = false;
-        result.message = getLastError();
+        result.message = checkoutError;
         return result;
     }
 
@@ -1053,55 +2357,28 @@ GitTaskResult GitWorker::handleMerge(const GitTaskRequest& req)
         return result;
     }
 
-    git_merge_options merge_opts = GIT_MERGE_OPTIONS_INIT;
-    git_checkout_options checkout_opts = GIT_CHECKOUT_OPTIONS_INIT;
-    checkout_opts.checkout_strategy = GIT_CHECKOUT_SAFE;
+    git_annotated_commit_free(annotated);
 
-    if (git_merge(repo, heads, 1, &merge_opts, &checkout_opts) != 0) {
-        git_annotated_commit_free(annotated);
+    GitRef head;
+    if (git_repository_head(head.ptr(), repo) != 0) {
         result.success = false;
         result.message = getLastError();
         return result;
     }
 
-    // Check for conflicts
-    GitIndex index;
-    git_repository_index(index.ptr(), repo);
-    if (git_index_has_conflicts(index)) {
-        git_annotated_commit_free(annotated);
+    QStringList conflicts;
+    QString msg = QString("Merge branch '%1'").arg(sourceBranch);
+    if (!mergeIntoHead(repo, head, git_reference_target(source), msg, &conflicts, &result.message,
+                       progressReporter(req.requestId))) {
         result.success = false;
-        result.message = "Merge conflicts - resolve manually";
+        if (!conflicts.isEmpty()) {
+            QVariantMap data;
+            data["conflicts"] = conflicts;
+            result.data = data;
+        }
         return result;
     }
 
-    // Create merge commit
-    GitSignature sig;
-    git_signature_default(sig.ptr(), repo);
-
-    git_oid tree_oid;
-    git_index_write_tree(&tree_oid, index);
-
-    GitTree tree;
-    git_tree_lookup(tree.ptr(), repo, &tree_oid);
-
-    GitRef head;
-    git_repository_head(head.ptr(), repo);
-
-    GitCommit head_commit;
-    git_commit_lookup(head_commit.ptr(), repo, git_reference_target(head));
-
-    GitCommit source_commit;
-    git_commit_lookup(source_commit.ptr(), repo, git_reference_target(source));
-
-    QString msg = QString("Merge branch '%1'").arg(sourceBranch);
-    const git_commit* parents[] = { head_commit, source_commit };
-    git_oid new_commit_oid;
-    git_commit_create(&new_commit_oid, repo, "HEAD", sig, sig,
-                      nullptr, msg.toUtf8().constData(), tree, 2, parents);
-
-    git_repository_state_cleanup(repo);
-    git_annotated_commit_free(annotated);
-
     // Auto-delete source if on master/main
     QString currentBranch = getCurrentBranch(req.repoPath);
     if (currentBranch == "master" || currentBranch == "main") {
@@ -1251,56 +2528,28 @@ GitTaskResult GitWorker::handleGetBranches(const GitTaskRequest& req)
     GitTaskResult result;
     result.requestId = req.requestId;
 
-    GitRepo repo;
-    if (!repo.open(req.repoPath)) {
+    if (!RefReader::resolveGitDir(req.repoPath).isValid()) {
         result.success = false;
-        result.message = getLastError();
+        result.message = "Not a git repository";
         return result;
     }
 
-    QStringList localBranches;
-    QStringList remoteBranches;
-
-    // Local branches
-    git_branch_iterator* iter = nullptr;
-    git_branch_iterator_new(&iter, repo, GIT_BRANCH_LOCAL);
-
-    git_reference* ref = nullptr;
-    git_branch_t type;
-    while (git_branch_next(&ref, &type, iter) == 0) {
-        const char* name = nullptr;
-        git_branch_name(&name, ref);
-        localBranches.append(QString::fromUtf8(name));
-        git_reference_free(ref);
-    }
-    git_branch_iterator_free(iter);
-
-    // Remote branches
-    git_branch_iterator_new(&iter, repo, GIT_BRANCH_REMOTE);
-    while (git_branch_next(&ref, &type, iter) == 0) {
-        const char* name = nullptr;
-        git_branch_name(&name, ref);
-        QString branchName = QString::fromUtf8(name);
-        // Remove "origin/" prefix
-        if (branchName.startsWith("origin/")) {
-            branchName = branchName.mid(7);
-        }
-        if (!branchName.contains("HEAD") && !localBranches.contains(branchName)) {
-            remoteBranches.append(branchName);
-        }
-        git_reference_free(ref);
+    // Nothing moved since the last answer: reuse it
+    ResultStamp stamp = resultStamp(req.repoPath);
+    if (m_statusCache.lookupBranches(req.repoPath, stamp, &result.data)) {
+        result.success = true;
+        return result;
     }
-    git_branch_iterator_free(iter);
 
-    QString currentBranch = getCurrentBranch(req.repoPath);
-
-    localBranches.sort(Qt::CaseInsensitive);
-    remoteBranches.sort(Qt::CaseInsensitive);
+    // Sorted lists kept per repo, only rebuilt where refs changed
+    BranchList branches = m_branchIndex.branches(req.repoPath);
 
     QVariantMap branchData;
-    branchData["local"] = localBranches;
-    branchData["remote"] = remoteBranches;
-    branchData["current"] = currentBranch;
+    branchData["local"] = branches.local;
+    branchData["remote"] = branches.remoteOnly;
+    branchData["current"] = stamp.headRef;
+
+    m_statusCache.storeBranches(req.repoPath, stamp, branchData);
 
     result.success = true;
     result.data = branchData;
@@ -1312,6 +2561,13 @@ GitTaskResult GitWorker::handleGetChanges(const GitTaskRequest& req)
     GitTaskResult result;
     result.requestId = req.requestId;
 
+    // Stamps are taken before the status so a change during it is not masked
+    ResultStamp stamp = resultStamp(req.repoPath);
+    if (m_statusCache.lookupChanges(req.repoPath, stamp, &result.data)) {
+        result.success = true;
+        return result;
+    }
+
     GitRepo repo;
     if (!repo.open(req.repoPath)) {
         result.success = false;
@@ -1319,8 +2575,17 @@ GitTaskResult GitWorker::handleGetChanges(const GitTaskRequest& req)
         return result;
     }
 
-    QStringList modifiedFiles;
-    QStringList stagedFiles;
+    // Kept as libgit2's UTF-8 all the way to the view
+    Utf8List modifiedFiles;
+    Utf8List stagedFiles;
+
+    // Workdir stamped before the status too, like `stamp` above
+    bool bare = git_repository_is_bare(repo);
+    WorkdirSnapshot workdir;
+    qint64 cutoffNs = racyCutoffNs();
+    if (!bare) {
+        snapshotTracked(req.repoPath, repo, &workdir);
+    }
 
     git_status_options opts = GIT_STATUS_OPTIONS_INIT;
     opts.show = GIT_STATUS_SHOW_INDEX_AND_WORKDIR;
@@ -1333,47 +2598,46 @@ GitTaskResult GitWorker::handleGetChanges(const GitTaskRequest& req)
         return result;
     }
 
+    // Hidden paths, matched on libgit2's UTF-8 before any QString exists
+    static const PathFilter hidden({".idea/", "venv/"}, {"/__pycache__/"});
+
     size_t count = git_status_list_entrycount(status);
     for (size_t i = 0; i < count; i++) {
         const git_status_entry* entry = git_status_byindex(status, i);
 
-        QString path;
+        const char* rawPath = nullptr;
         if (entry->index_to_workdir && entry->index_to_workdir->new_file.path) {
-            path = QString::fromUtf8(entry->index_to_workdir->new_file.path);
+            rawPath = entry->index_to_workdir->new_file.path;
         } else if (entry->head_to_index && entry->head_to_index->new_file.path) {
-            path = QString::fromUtf8(entry->head_to_index->new_file.path);
-        }
-
-        if (path.isEmpty()) continue;
-
-        // Filter patterns
-        if (path.startsWith(".idea/") || path.contains("/__pycache__/") || path.startsWith("venv/")) {
-            continue;
-        }
-
-        // Staged changes
-        if (entry->status & (GIT_STATUS_INDEX_NEW | GIT_STATUS_INDEX_MODIFIED |
-                             GIT_STATUS_INDEX_DELETED | GIT_STATUS_INDEX_RENAMED)) {
-            if (!stagedFiles.contains(path)) {
-                stagedFiles.append(path);
-            }
+            rawPath = entry->head_to_index->new_file.path;
         }
 
-        // Workdir changes (not staged)
-        if (entry->status & (GIT_STATUS_WT_NEW | GIT_STATUS_WT_MODIFIED |
-                             GIT_STATUS_WT_DELETED | GIT_STATUS_WT_RENAMED)) {
-            if (!modifiedFiles.contains(path) && !stagedFiles.contains(path)) {
-                modifiedFiles.append(path);
-            }
+        qsizetype length = rawPath ? qsizetype(std::strlen(rawPath)) : 0;
+        if (length == 0 || hidden.matches(rawPath, length)) continue;
+
+        // One entry per path: staged wins over workdir changes to the same file
+        bool staged = entry->status & (GIT_STATUS_INDEX_NEW | GIT_STATUS_INDEX_MODIFIED |
+                                       GIT_STATUS_INDEX_DELETED | GIT_STATUS_INDEX_RENAMED);
+        bool modified = entry->status & (GIT_STATUS_WT_NEW | GIT_STATUS_WT_MODIFIED |
+                                         GIT_STATUS_WT_DELETED | GIT_STATUS_WT_RENAMED);
+        if (staged) {
+            stagedFiles.append(rawPath, length);
+        } else if (modified) {
+            modifiedFiles.append(rawPath, length);
         }
     }
 
-    modifiedFiles.sort(Qt::CaseInsensitive);
-    stagedFiles.sort(Qt::CaseInsensitive);
+    modifiedFiles.sortCaseInsensitive();
+    stagedFiles.sortCaseInsensitive();
 
     QVariantMap changeData;
-    changeData["modified"] = modifiedFiles;
-    changeData["staged"] = stagedFiles;
+    changeData["modified"] = QVariant::fromValue(modifiedFiles);
+    changeData["staged"] = QVariant::fromValue(stagedFiles);
+
+    if (!bare) {
+        snapshotUntracked(repo, cutoffNs, &workdir);
+        m_statusCache.storeChanges(req.repoPath, stamp, workdir, changeData);
+    }
 
     result.success = true;
     result.data = changeData;
@@ -1385,22 +2649,24 @@ GitTaskResult GitWorker::handleGetDiff(const GitTaskRequest& req)
     GitTaskResult result;
     result.requestId = req.requestId;
 
-    if (req.args.isEmpty()) {
+    // Raw path from GetChanges when the caller kept it, else the argument
+    QByteArray pathBytes = !req.paths.isEmpty() ? req.paths.view(0).toByteArray()
+                                                : req.args.value(0).toUtf8();
+    if (pathBytes.isEmpty()) {
         result.success = false;
         result.message = "File path required";
         return result;
     }
 
-    QString filePath = req.args[0];
-
-    // Check for binary
-    QStringList binaryExtensions = {
-        ".ods", ".odg", ".odt", ".Z3PRT", ".Z3ASM", ".exe",
-        ".Z3DRW", ".stp", ".step", ".xrs", ".pdf"
+    // Check for binary (extensions are ASCII, compared lower-case)
+    static const QByteArrayList binaryExtensions = {
+        ".ods", ".odg", ".odt", ".z3prt", ".z3asm", ".exe",
+        ".z3drw", ".stp", ".step", ".xrs", ".pdf"
     };
 
-    for (const QString& ext : binaryExtensions) {
-        if (filePath.endsWith(ext, Qt::CaseInsensitive)) {
+    QByteArray lowerPath = pathBytes.toLower();
+    for (const QByteArray& ext : binaryExtensions) {
+        if (lowerPath.endsWith(ext)) {
             result.success = false;
             result.message = "Binary file - diff not available";
             return result;
@@ -1415,7 +2681,6 @@ GitTaskResult GitWorker::handleGetDiff(const GitTaskRequest& req)
     }
 
     git_diff_options opts = GIT_DIFF_OPTIONS_INIT;
-    QByteArray pathBytes = filePath.toUtf8();
     char* pathStr = pathBytes.data();
     opts.pathspec.strings = &pathStr;
     opts.pathspec.count = 1;
@@ -1427,19 +2692,362 @@ GitTaskResult GitWorker::handleGetDiff(const GitTaskRequest& req)
         return result;
     }
 
-    QString diffOutput;
+    // Collected as bytes, decoded once for the viewer
+    QByteArray diffOutput;
 
     git_diff_print(diff, GIT_DIFF_FORMAT_PATCH,
         [](const git_diff_delta*, const git_diff_hunk*,
            const git_diff_line* line, void* payload) -> int {
-            QString* output = static_cast<QString*>(payload);
+            QByteArray* output = static_cast<QByteArray*>(payload);
             if (line->content && line->content_len > 0) {
-                *output += QString::fromUtf8(line->content, static_cast<int>(line->content_len));
+                output->append(line->content, qsizetype(line->content_len));
             }
             return 0;
         }, &diffOutput);
 
     result.success = true;
-    result.data = diffOutput;
+    result.data = QString::fromUtf8(diffOutput);
+    return result;
+}
+
+QVariantList GitWorker::runBatch(const GitTaskRequest& req, const QStringList& repos,
+                                 const std::function<GitTaskResult(const QString&)>& job)
+{
+    // Each job opens its own git_repository, libgit2 is safe that way
+    QThreadPool pool;
+    pool.setMaxThreadCount(threadCount());
+
+    QMutex resultsMutex;
+    QVariantList results;
+    int total = repos.size();
+    int done = 0;
+
+    for (const QString& repoPath : repos) {
+        pool.start([&, repoPath]() {
+            GitTaskResult item = job(repoPath);
+            item.requestId = req.requestId;
+            item.task = req.task;
+            emit batchItemCompleted(item);
+
+            QVariantMap entry;
+            entry["path"] = repoPath;
+            entry["success"] = item.success;
+            entry["message"] = item.message;
+            if (item.data.toMap().contains("conflicts")) {
+                entry["conflicts"] = item.data.toMap()["conflicts"];
+            }
+            if (item.data.toMap().value("skipped").toBool()) {
+                entry["skipped"] = true;
+            }
+
+            QMutexLocker locker(&resultsMutex);
+            results.append(entry);
+            done++;
+            emit progressUpdate(req.requestId, (done * 100) / total,
+                                QString("%1/%2 repositories").arg(done).arg(total));
+        });
+    }
+
+    pool.waitForDone();
+    return results;
+}
+
+GitTaskResult GitWorker::pullFastForwardOnly(const QString& repoPath)
+{
+    GitTaskResult result;
+
+    GitRepo repo;
+    if (!repo.open(repoPath)) {
+        result.success = false;
+        result.message = getLastError();
+        return result;
+    }
+
+    if (!fetchOrigin(repo, &result.message)) {
+        result.success = false;
+        return result;
+    }
+
+    GitRef head;
+    GitRef upstream;
+    if (git_repository_head(head.ptr(), repo) != 0 ||
+        git_branch_upstream(upstream.ptr(), head) != 0) {
+        result.success = false;
+        result.message = "No upstream branch configured";
+        return result;
+    }
+
+    const git_oid* local_oid = git_reference_target(head);
+    const git_oid* upstream_oid = git_reference_target(upstream);
+    if (!local_oid || !upstream_oid) {
+        result.success = false;
+        result.message = "Cannot get upstream target";
+        return result;
+    }
+
+    bool skipped = false;
+    if (git_oid_equal(local_oid, upstream_oid) ||
+        git_graph_descendant_of(repo, local_oid, upstream_oid) == 1) {
+        result.success = true;
+        result.message = "Already up to date";
+    } else if (git_graph_descendant_of(repo, upstream_oid, local_oid) != 1) {
+        // Diverged: needs a merge, left for an interactive pull
+        result.success = false;
+        result.message = "Skipped - needs merge";
+        return result;
+    } else if (hasUncommittedChanges(repoPath)) {
+        // Picked from the last status sweep, which may predate an edit
+        result.success = false;
+        result.message = "Skipped - local changes";
+        skipped = true;
+    } else if (!moveHead(repo, head, upstream_oid, "pull: fast-forward", &result.message)) {
+        result.success = false;
+        return result;
+    } else {
+        result.success = true;
+        result.message = "Fast-forwarded";
+    }
+
+    // Fresh status so the tree icon updates as results stream in
+    GitTaskRequest statusReq;
+    statusReq.repoPath = repoPath;
+    QVariantMap data = handleCheckStatus(statusReq).data.toMap();
+    if (skipped) {
+        data["skipped"] = true;
+    }
+    result.data = data;
+    return result;
+}
+
+GitTaskResult GitWorker::handlePullAllClean(const GitTaskRequest& req)
+{
+    GitTaskResult result;
+    result.requestId = req.requestId;
+
+    // Targets: behind upstream and nothing local, per the last status sweep
+    QStringList targets;
+    for (const QString& path : req.args) {
+        RepoStatus status;
+        if (m_statusCache.lookupStatus(path, &status) &&
+            status.behind > 0 && !status.needsCommit && !status.hasError) {
+            targets.append(path);
+        }
+    }
+
+    if (targets.isEmpty()) {
+        result.success = true;
+        result.message = "No clean repository behind upstream";
+        return result;
+    }
+
+    QVariantList items = runBatch(req, targets, [this](const QString& repoPath) {
+        return pullFastForwardOnly(repoPath);
+    });
+
+    int updated = 0;
+    int skippedCount = 0;
+    for (const QVariant& item : items) {
+        QVariantMap entry = item.toMap();
+        if (entry["success"].toBool()) updated++;
+        if (entry.value("skipped").toBool()) skippedCount++;
+    }
+
+    QVariantMap batchData;
+    batchData["batch"] = items;
+
+    result.success = true;
+    result.data = batchData;
+    result.message = QString("Pulled %1/%2 repositories").arg(updated).arg(targets.size());
+    if (skippedCount > 0) {
+        result.message += QString(", %1 skipped with local changes").arg(skippedCount);
+    }
+    return result;
+}
+
+GitTaskResult GitWorker::pushAhead(const QString& repoPath)
+{
+    GitTaskResult result;
+
+    GitRepo repo;
+    if (!repo.open(repoPath)) {
+        result.success = false;
+        result.message = getLastError();
+        return result;
+    }
+
+    if (!pushHead(repo, &result.message)) {
+        result.success = false;
+        return result;
+    }
+
+    result.success = true;
+    result.message = "Pushed";
+
+    // Fresh status so the tree icon updates as results stream in
+    GitTaskRequest statusReq;
+    statusReq.repoPath = repoPath;
+    result.data = handleCheckStatus(statusReq).data;
+    return result;
+}
+
+GitTaskResult GitWorker::handlePushAll(const GitTaskRequest& req)
+{
+    GitTaskResult result;
+    result.requestId = req.requestId;
+
+    // Targets: ahead of upstream, per the last status sweep
+    QStringList targets;
+    for (const QString& path : req.args) {
+        RepoStatus status;
+        if (m_statusCache.lookupStatus(path, &status) &&
+            status.needsPush && !status.hasError) {
+            targets.append(path);
+        }
+    }
+
+    if (targets.isEmpty()) {
+        result.success = true;
+        result.message = "No repository ahead of upstream";
+        return result;
+    }
+
+    QVariantList items = runBatch(req, targets, [this](const QString& repoPath) {
+        return pushAhead(repoPath);
+    });
+
+    int pushed = 0;
+    for (const QVariant& item : items) {
+        if (item.toMap()["success"].toBool()) pushed++;
+    }
+
+    QVariantMap batchData;
+    batchData["batch"] = items;
+
+    result.success = true;
+    result.data = batchData;
+    result.message = QString("Pushed %1/%2 repositories").arg(pushed).arg(targets.size());
+    return result;
+}
+
+GitTaskResult GitWorker::mergeBranchInto(const QString& repoPath, const QString& sourceBranch,
+                                         const QString& targetBranch)
+{
+    GitTaskResult result;
+    QVariantMap skipped;
+    skipped["skipped"] = true;
+
+    GitRepo repo;
+    if (!repo.open(repoPath)) {
+        result.success = false;
+        result.message = getLastError();
+        return result;
+    }
+
+    GitRef source;
+    if (git_branch_lookup(source.ptr(), repo, sourceBranch.toUtf8().constData(), GIT_BRANCH_LOCAL) != 0) {
+        result.success = false;
+        result.message = "Skipped - branch not found";
+        result.data = skipped;
+        return result;
+    }
+
+    GitRef head;
+    if (git_repository_head(head.ptr(), repo) != 0) {
+        result.success = false;
+        result.message = getLastError();
+        return result;
+    }
+
+    // Only repositories sitting on the target branch are merged into
+    if (!git_reference_is_branch(head) ||
+        QString::fromUtf8(git_reference_shorthand(head)) != targetBranch) {
+        result.success = false;
+        result.message = git_reference_is_branch(head)
+            ? QString("Skipped - on '%1', not '%2'").arg(QString::fromUtf8(git_reference_shorthand(head)), targetBranch)
+            : QString("Skipped - detached HEAD, not on '%1'").arg(targetBranch);
+        result.data = skipped;
+        return result;
+    }
+
+    const git_oid* head_oid = git_reference_target(head);
+    const git_oid* source_oid = git_reference_target(source);
+    if (git_oid_equal(head_oid, source_oid) ||
+        git_graph_descendant_of(repo, head_oid, source_oid) == 1) {
+        result.success = true;
+        result.message = "Already up to date";
+        return result;
+    }
+
+    // Pre-check in memory, writes the workdir only when clean
+    QStringList conflicts;
+    QString msg = QString("Merge branch '%1'").arg(sourceBranch);
+    if (!mergeIntoHead(repo, head, source_oid, msg, &conflicts, &result.message)) {
+        result.success = false;
+        if (!conflicts.isEmpty()) {
+            QVariantMap data;
+            data["conflicts"] = conflicts;
+            result.data = data;
+        }
+        return result;
+    }
+
+    result.success = true;
+    result.message = QString("Merged into %1").arg(git_reference_shorthand(head));
+
+    // Fresh status so the tree icon updates as results stream in
+    GitTaskRequest statusReq;
+    statusReq.repoPath = repoPath;
+    result.data = handleCheckStatus(statusReq).data;
+    return result;
+}
+
+GitTaskResult GitWorker::handleMergeAll(const GitTaskRequest& req)
+{
+    GitTaskResult result;
+    result.requestId = req.requestId;
+
+    if (req.args.size() < 2 || req.args[0].isEmpty() || req.args[1].isEmpty()) {
+        result.success = false;
+        result.message = "Source and target branch required";
+        return result;
+    }
+
+    QString sourceBranch = req.args[0];
+    QString targetBranch = req.args[1];
+    QStringList repos = req.args.mid(2);
+
+    if (repos.isEmpty()) {
+        result.success = false;
+        result.message = "No repository selected";
+        return result;
+    }
+
+    QVariantList items = runBatch(req, repos, [this, sourceBranch, targetBranch](const QString& repoPath) {
+        return mergeBranchInto(repoPath, sourceBranch, targetBranch);
+    });
+
+    int merged = 0;
+    int conflicted = 0;
+    int skippedCount = 0;
+    for (const QVariant& item : items) {
+        QVariantMap entry = item.toMap();
+        if (entry["success"].toBool()) merged++;
+        if (entry.contains("conflicts")) conflicted++;
+        if (entry.value("skipped").toBool()) skippedCount++;
+    }
+
+    QVariantMap batchData;
+    batchData["batch"] = items;
+
+    result.success = true;
+    result.data = batchData;
+    result.message = QString("Merged '%1' into '%2' in %3/%4 repositories")
+                         .arg(sourceBranch, targetBranch).arg(merged).arg(repos.size());
+    if (conflicted > 0) {
+        result.message += QString(", %1 with conflicts").arg(conflicted);
+    }
+    if (skippedCount > 0) {
+        result.message += QString(", %1 skipped").arg(skippedCount);
+    }
     return result;
 }
@@ -9,6 +9,11 @@
 #include <QString>
 #include <QStringList>
 #include <QVariant>
+#include <atomic>
+#include <functional>
+#include "git/StatusCache.h"
+#include "git/BranchIndex.h"
+#include "core/Utf8List.h"
 
 /**
  * Git task types that can be executed by GitWorker
@@ -30,7 +35,10 @@ enum class GitTask {
     StashPop,           // git stash pop
     GetBranches,        // list branches
     GetChanges,         // list modified files
-    GetDiff             // git diff for single file
+    GetDiff,            // git diff for single file
+    PullAllClean,       // fetch + fast-forward every clean repo behind upstream
+    PushAll,            // push every repo ahead of upstream
+    MergeAll            // merge one branch into many repos, args: source, target, repos
 };
 
 /**
@@ -40,11 +48,14 @@ struct GitTaskRequest {
     GitTask task;
     QString repoPath;
     QStringList args;       // task-specific arguments
+    Utf8List paths;         // Commit, GetDiff: repo-relative paths as libgit2 takes them
     int requestId;          // for matching responses
+    bool prefetch;          // speculative, runs only when nothing else is queued
 
     GitTaskRequest()
         : task(GitTask::CheckStatus)
         , requestId(0)
+        , prefetch(false)
     {}
 };
 
@@ -54,6 +65,7 @@ struct GitTaskRequest {
 struct GitTaskResult {
     int requestId;
     GitTask task;           // which task this result is for
+    QString repoPath;       // repository of the request
     bool success;
     QString message;
     QVariant data;          // task-specific result data
@@ -77,13 +89,30 @@ public:
     explicit GitWorker(QObject *parent = nullptr);
     ~GitWorker() override;
 
+    // Workdir snapshots, shared with RepoWatcher
+    StatusCache* statusCache() { return &m_statusCache; }
+
+    // Repository open behaviour, applies to repositories opened afterwards
+    static void setOpenOptions(const QStringList& ceilingDirs, bool directGitDirOpen);
+
+    // Parallel repositories for bulk tasks (0 = one per core)
+    void setConcurrency(int concurrency);
+
+    // Submodules are discovered as repositories of their own, so a parent's
+    // status leaves their workdirs out
+    void setSubmoduleRows(bool submoduleRows);
+
 signals:
     void taskCompleted(GitTaskResult result);
     void progressUpdate(int requestId, int percent, QString status);
+    void snapshotStored(const QString& repoPath);
+    void batchItemCompleted(GitTaskResult result);     // per-repo result of a bulk task
+    void prefetchCompleted(GitTaskResult result);      // result of a prefetch request
 
 public slots:
     void queueTask(GitTaskRequest request);
     void cancelTask(int requestId);
+    void clearPrefetchQueue();
     void stopWorker();
 
 protected:
@@ -91,13 +120,24 @@ protected:
 
 private:
     QQueue<GitTaskRequest> m_taskQueue;
+    QQueue<GitTaskRequest> m_prefetchQueue;     // drained only when m_taskQueue is empty
     QMutex m_queueMutex;
     QWaitCondition m_queueCondition;
     bool m_running;
+    std::atomic<int> m_concurrency;
+    std::atomic<bool> m_submoduleRows;
+    StatusCache m_statusCache;
+    BranchIndex m_branchIndex;
 
     // Helper to get last libgit2 error
     QString getLastError();
 
+    // Threads for parallel work: the configured concurrency, or one per core
+    int threadCount() const;
+
+    // Emits progressUpdate for `requestId`, for libgit2 progress callbacks
+    std::function<void(int, const QString&)> progressReporter(int requestId);
+
     // Task handlers (libgit2-based)
     GitTaskResult handleCheckStatus(const GitTaskRequest& req);
     GitTaskResult handleCheckAllStatus(const GitTaskRequest& req);
@@ -116,6 +156,17 @@ private:
     GitTaskResult handleGetBranches(const GitTaskRequest& req);
     GitTaskResult handleGetChanges(const GitTaskRequest& req);
     GitTaskResult handleGetDiff(const GitTaskRequest& req);
+    GitTaskResult handlePullAllClean(const GitTaskRequest& req);
+    GitTaskResult handlePushAll(const GitTaskRequest& req);
+    GitTaskResult handleMergeAll(const GitTaskRequest& req);
+
+    // Bulk helpers: run `job` on each repo in parallel, streaming results
+    QVariantList runBatch(const GitTaskRequest& req, const QStringList& repos,
+                          const std::function<GitTaskResult(const QString&)>& job);
+    GitTaskResult pullFastForwardOnly(const QString& repoPath);
+    GitTaskResult pushAhead(const QString& repoPath);
+    GitTaskResult mergeBranchInto(const QString& repoPath, const QString& sourceBranch,
+                                  const QString& targetBranch);
 
     // Helper functions
     QString getCurrentBranch(const QString& repoPath);
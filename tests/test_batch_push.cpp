@@ -0,0 +1,298 @@
+/**
+ * Bulk push test for GitSardine
+ * Pushes many clones to local bare repositories through GitWorker and
+ * checks every repository is pushed and that jobs run side by side when
+ * the concurrency setting allows it. Timings are only logged.
+ */
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QSemaphore>
+#include <QMutex>
+#include <QSet>
+#include <QThread>
+#include <QDebug>
+#include <git2.h>
+#include "workers/GitWorker.h"
+
+static const int REPO_COUNT = 16;
+static const int PARALLEL = 4;
+
+class BatchPushTest {
+public:
+    bool run() {
+        qDebug() << "=== Batch push Test ===\n";
+
+        QTemporaryDir tempDir;
+        if (!tempDir.isValid()) {
+            qCritical() << "FAIL: Could not create temp directory";
+            return false;
+        }
+
+        // Harness: REPO_COUNT clones, each tracking its own bare origin
+        QDir base(tempDir.path());
+        QStringList clones;
+        for (int i = 0; i < REPO_COUNT; i++) {
+            QString origin = base.filePath(QString("origin%1.git").arg(i));
+            QString clone = base.filePath(QString("clone%1").arg(i));
+            if (!createPair(origin, clone)) {
+                qCritical() << "FAIL: Could not create repository pair" << i;
+                return false;
+            }
+            clones.append(clone);
+        }
+
+        GitWorker worker;
+        worker.start();
+
+        // Test 1: serial push of one commit per repo
+        qDebug() << "\n--- Test 1: concurrency 1 ---";
+        qint64 serialMs = 0;
+        int serialThreads = 0;
+        if (!commitAll(clones, "serial") || !pushAll(&worker, clones, 1, &serialMs, &serialThreads)) {
+            return false;
+        }
+        qDebug() << "Pushed" << clones.size() << "repositories in" << serialMs << "ms";
+        if (serialThreads != 1) {
+            qCritical() << "FAIL: concurrency 1 ran jobs on" << serialThreads << "threads";
+            return false;
+        }
+        qDebug() << "PASS";
+
+        // Test 2: same workload in parallel
+        qDebug() << "\n--- Test 2: concurrency" << PARALLEL << "---";
+        qint64 parallelMs = 0;
+        int parallelThreads = 0;
+        if (!commitAll(clones, "parallel") ||
+            !pushAll(&worker, clones, PARALLEL, &parallelMs, &parallelThreads)) {
+            return false;
+        }
+        qDebug() << "Pushed" << clones.size() << "repositories in" << parallelMs << "ms";
+        qDebug() << "Speedup:" << (parallelMs > 0 ? double(serialMs) / parallelMs : double(PARALLEL));
+
+        // Jobs overlapped: results came from several pool threads at once,
+        // never more than the setting allows. Wall-clock time is too noisy
+        // on shared machines to assert on.
+        if (parallelThreads < 2 || parallelThreads > PARALLEL) {
+            qCritical() << "FAIL: concurrency" << PARALLEL << "ran jobs on" << parallelThreads << "threads";
+            return false;
+        }
+        qDebug() << "PASS";
+
+        worker.stopWorker();
+        worker.wait();
+
+        qDebug() << "\n=== ALL TESTS PASSED ===";
+        return true;
+    }
+
+private:
+    int m_requestId = 1;
+
+    // Run one task and wait for its result (handled on the worker thread)
+    GitTaskResult runTask(GitWorker* worker, const GitTaskRequest& req) {
+        QSemaphore done;
+        GitTaskResult out;
+        QMetaObject::Connection conn = QObject::connect(worker, &GitWorker::taskCompleted,
+            [&](GitTaskResult result) {
+                if (result.requestId == req.requestId) {
+                    out = result;
+                    done.release();
+                }
+            }, Qt::DirectConnection);
+        worker->queueTask(req);
+        done.acquire();
+        QObject::disconnect(conn);
+        return out;
+    }
+
+    bool pushAll(GitWorker* worker, const QStringList& clones, int concurrency, qint64* elapsedMs,
+                 int* threadsUsed) {
+        // PushAll picks its targets from the last status sweep
+        GitTaskRequest statusReq;
+        statusReq.task = GitTask::CheckAllStatus;
+        statusReq.args = clones;
+        statusReq.requestId = m_requestId++;
+        runTask(worker, statusReq);
+
+        worker->setConcurrency(concurrency);
+
+        GitTaskRequest pushReq;
+        pushReq.task = GitTask::PushAll;
+        pushReq.args = clones;
+        pushReq.requestId = m_requestId++;
+
+        // Per-repo results are emitted from the thread that ran the job
+        QMutex threadsMutex;
+        QSet<QThread*> threads;
+        QMetaObject::Connection conn = QObject::connect(worker, &GitWorker::batchItemCompleted,
+            [&](GitTaskResult item) {
+                if (item.requestId == pushReq.requestId) {
+                    QMutexLocker locker(&threadsMutex);
+                    threads.insert(QThread::currentThread());
+                }
+            }, Qt::DirectConnection);
+
+        QElapsedTimer timer;
+        timer.start();
+        GitTaskResult result = runTask(worker, pushReq);
+        *elapsedMs = timer.elapsed();
+        QObject::disconnect(conn);
+        *threadsUsed = threads.size();
+
+        QVariantList items = result.data.toMap()["batch"].toList();
+        if (items.size() != clones.size()) {
+            qCritical() << "FAIL: Expected" << clones.size() << "pushes, got" << items.size()
+                        << result.message;
+            return false;
+        }
+        for (const QVariant& item : items) {
+            QVariantMap entry = item.toMap();
+            if (!entry["success"].toBool()) {
+                qCritical() << "FAIL: Push failed for" << entry["path"].toString()
+                            << entry["message"].toString();
+                return false;
+            }
+        }
+
+        // Every clone must now match its origin
+        for (const QString& clone : clones) {
+            if (!inSync(clone)) {
+                qCritical() << "FAIL: Origin not updated for" << clone;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool commitAll(const QStringList& clones, const QString& tag) {
+        for (const QString& clone : clones) {
+            git_repository* repo = nullptr;
+            if (git_repository_open(&repo, clone.toUtf8().constData()) != 0) {
+                return false;
+            }
+            bool ok = commitFile(repo, tag + ".txt", tag.toUtf8());
+            git_repository_free(repo);
+            if (!ok) {
+                qCritical() << "FAIL: Could not commit in" << clone;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool createPair(const QString& origin, const QString& clone) {
+        git_repository* bare = nullptr;
+        if (git_repository_init(&bare, origin.toUtf8().constData(), 1) != 0) {
+            return false;
+        }
+        git_repository_free(bare);
+
+        git_repository* repo = nullptr;
+        if (git_repository_init(&repo, clone.toUtf8().constData(), 0) != 0) {
+            return false;
+        }
+
+        bool ok = commitFile(repo, "README", "initial\n");
+
+        // Publish the initial commit and track it as upstream
+        git_remote* remote = nullptr;
+        git_reference* head = nullptr;
+        git_reference* branch = nullptr;
+        ok = ok && git_remote_create(&remote, repo, "origin", origin.toUtf8().constData()) == 0;
+        ok = ok && git_repository_head(&head, repo) == 0;
+        if (ok) {
+            QByteArray refspec = QByteArray(git_reference_name(head)) + ":" + git_reference_name(head);
+            const char* refspecStr = refspec.constData();
+            git_strarray refspecs = { const_cast<char**>(&refspecStr), 1 };
+            ok = git_remote_push(remote, &refspecs, nullptr) == 0;
+        }
+        ok = ok && git_reference_lookup(&branch, repo, git_reference_name(head)) == 0;
+        if (ok) {
+            QByteArray upstream = QByteArray("origin/") + git_reference_shorthand(head);
+            ok = git_branch_set_upstream(branch, upstream.constData()) == 0;
+        }
+
+        git_reference_free(branch);
+        git_reference_free(head);
+        git_remote_free(remote);
+        git_repository_free(repo);
+        return ok;
+    }
+
+    bool commitFile(git_repository* repo, const QString& name, const QByteArray& content) {
+        QFile file(QDir(QString::fromUtf8(git_repository_workdir(repo))).filePath(name));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            return false;
+        }
+        file.write(content);
+        file.close();
+
+        git_index* index = nullptr;
+        git_oid treeId, commitId;
+        git_tree* tree = nullptr;
+        git_signature* sig = nullptr;
+        git_commit* parent = nullptr;
+        git_reference* head = nullptr;
+
+        bool ok = git_repository_index(&index, repo) == 0 &&
+                  git_index_add_bypath(index, name.toUtf8().constData()) == 0 &&
+                  git_index_write(index) == 0 &&
+                  git_index_write_tree(&treeId, index) == 0 &&
+                  git_tree_lookup(&tree, repo, &treeId) == 0 &&
+                  git_signature_now(&sig, "Test", "test@example.com") == 0;
+
+        // Unborn HEAD on the first commit
+        if (ok && git_repository_head(&head, repo) == 0) {
+            ok = git_commit_lookup(&parent, repo, git_reference_target(head)) == 0;
+        }
+
+        if (ok) {
+            const git_commit* parents[] = { parent };
+            ok = git_commit_create(&commitId, repo, "HEAD", sig, sig, nullptr,
+                                   "test commit", tree, parent ? 1 : 0, parents) == 0;
+        }
+
+        git_reference_free(head);
+        git_commit_free(parent);
+        git_signature_free(sig);
+        git_tree_free(tree);
+        git_index_free(index);
+        return ok;
+    }
+
+    bool inSync(const QString& clone) {
+        git_repository* repo = nullptr;
+        git_reference* head = nullptr;
+        git_repository* bare = nullptr;
+        git_reference* remoteHead = nullptr;
+
+        bool ok = git_repository_open(&repo, clone.toUtf8().constData()) == 0 &&
+                  git_repository_head(&head, repo) == 0;
+
+        QString origin = QDir(clone).absoluteFilePath(
+            QString("../origin%1.git").arg(QDir(clone).dirName().mid(5)));
+        ok = ok && git_repository_open_bare(&bare, QDir::cleanPath(origin).toUtf8().constData()) == 0 &&
+             git_reference_lookup(&remoteHead, bare, git_reference_name(head)) == 0 &&
+             git_oid_equal(git_reference_target(head), git_reference_target(remoteHead));
+
+        git_reference_free(remoteHead);
+        git_repository_free(bare);
+        git_reference_free(head);
+        git_repository_free(repo);
+        return ok;
+    }
+};
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    git_libgit2_init();
+    BatchPushTest test;
+    bool ok = test.run();
+    git_libgit2_shutdown();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,204 @@
+/**
+ * Index reader test for GitSardine
+ * Builds indexes with libgit2, edits the workdir and checks the stat-only
+ * comparison classifies the changes like a status list would
+ */
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QTemporaryDir>
+#include <QDebug>
+#include <git2.h>
+#include "git/IndexReader.h"
+
+class IndexReaderTest {
+public:
+    bool run() {
+        qDebug() << "=== Index reader Test ===\n";
+
+        QTemporaryDir tempDir;
+        if (!tempDir.isValid()) {
+            qCritical() << "FAIL: Could not create temp directory";
+            return false;
+        }
+        m_workdir = tempDir.path();
+
+        const QStringList files = {"a.txt", "dir/b.txt", "dir/sub/c.txt", "z.txt"};
+        if (git_repository_init(&m_repo, m_workdir.toUtf8().constData(), 0) != 0) {
+            qCritical() << "FAIL: Could not init repository";
+            return false;
+        }
+        for (const QString& file : files) {
+            writeFile(file, "content\n");
+        }
+        // Old timestamps keep the entries clear of the racy window
+        if (!ageFiles(files) || !stageAll(2)) {
+            qCritical() << "FAIL: Could not stage files";
+            return false;
+        }
+
+        // Test 1: untouched workdir
+        qDebug() << "\n--- Test 1: clean workdir ---";
+        IndexReader reader;
+        if (!reader.open(m_workdir) || reader.entryCount() != files.size()) {
+            qCritical() << "FAIL: Could not open index" << reader.entryCount();
+            return false;
+        }
+        if (reader.scan(m_workdir) != IndexReader::Clean) {
+            qCritical() << "FAIL: Untouched workdir not clean";
+            return false;
+        }
+        qDebug() << "PASS";
+
+        // Test 2: a resized file stops the scan
+        qDebug() << "\n--- Test 2: resized file ---";
+        writeFile("dir/b.txt", "content and more\n");
+        QStringList dirty;
+        if (reader.scan(m_workdir, &dirty) != IndexReader::Dirty ||
+            dirty != QStringList{"dir/b.txt"}) {
+            qCritical() << "FAIL: Resized file not reported" << dirty;
+            return false;
+        }
+        qDebug() << "PASS";
+
+        // Test 3: first N paths, in index order
+        qDebug() << "\n--- Test 3: first N dirty paths ---";
+        writeFile("a.txt", "changed content\n");
+        QFile::remove(QDir(m_workdir).filePath("dir/sub/c.txt"));
+        dirty.clear();
+        reader.scan(m_workdir, &dirty, 10);
+        if (dirty != QStringList{"a.txt", "dir/b.txt", "dir/sub/c.txt"}) {
+            qCritical() << "FAIL: Unexpected dirty paths" << dirty;
+            return false;
+        }
+        dirty.clear();
+        reader.scan(m_workdir, &dirty, 2);
+        if (dirty.size() != 2) {
+            qCritical() << "FAIL: maxPaths not honoured" << dirty;
+            return false;
+        }
+        qDebug() << "PASS";
+
+        // Test 4: a touched but identical file needs a content compare
+        qDebug() << "\n--- Test 4: touched file ---";
+        writeFile("a.txt", "content\n");
+        writeFile("dir/b.txt", "content\n");
+        writeFile("dir/sub/c.txt", "content\n");
+        if (reader.scan(m_workdir) != IndexReader::MaybeDirty) {
+            qCritical() << "FAIL: Touched files not reported as maybe dirty";
+            return false;
+        }
+        qDebug() << "PASS";
+
+        // Test 5: version 4 indexes are left to libgit2
+        qDebug() << "\n--- Test 5: unsupported index ---";
+        reader.close();
+        if (!ageFiles(files) || !stageAll(4)) {
+            qCritical() << "FAIL: Could not write version 4 index";
+            return false;
+        }
+        if (reader.open(m_workdir) || reader.scan(m_workdir) != IndexReader::Unsupported) {
+            qCritical() << "FAIL: Version 4 index was opened";
+            return false;
+        }
+        qDebug() << "PASS";
+
+        // Test 6: with autocrlf a resized file may still be clean
+        qDebug() << "\n--- Test 6: content filters ---";
+        if (!ageFiles(files) || !stageAll(2)) {
+            qCritical() << "FAIL: Could not write version 2 index";
+            return false;
+        }
+        writeFile("dir/b.txt", "content\r\n");
+        git_config* config = nullptr;
+        bool configured = git_repository_config(&config, m_repo) == 0 &&
+                          git_config_set_string(config, "core.autocrlf", "true") == 0;
+        git_config_free(config);
+        if (!configured || !reader.open(m_workdir) || !reader.hasFilters() ||
+            reader.scan(m_workdir) != IndexReader::MaybeDirty) {
+            qCritical() << "FAIL: Resized file under autocrlf not left to a content compare";
+            return false;
+        }
+        qDebug() << "PASS";
+
+        // Test 7: chmod +x is a change under core.filemode, only the ctime moves without it
+        qDebug() << "\n--- Test 7: exec bit ---";
+        QFile script(QDir(m_workdir).filePath("a.txt"));
+        dirty.clear();
+        if (!script.setPermissions(script.permissions() | QFileDevice::ExeOwner) ||
+            !reader.open(m_workdir) || reader.scan(m_workdir, &dirty, 10) != IndexReader::Dirty ||
+            dirty != QStringList{"a.txt"}) {
+            qCritical() << "FAIL: Exec bit change not reported" << dirty;
+            return false;
+        }
+        dirty.clear();
+        configured = git_repository_config(&config, m_repo) == 0 &&
+                     git_config_set_bool(config, "core.filemode", 0) == 0;
+        git_config_free(config);
+        if (!configured || !reader.open(m_workdir) ||
+            reader.scan(m_workdir, &dirty, 10) != IndexReader::MaybeDirty || !dirty.isEmpty()) {
+            qCritical() << "FAIL: Exec bit compared with core.filemode off" << dirty;
+            return false;
+        }
+        qDebug() << "PASS";
+
+        git_repository_free(m_repo);
+        qDebug() << "\n=== ALL TESTS PASSED ===";
+        return true;
+    }
+
+private:
+    QString m_workdir;
+    git_repository* m_repo = nullptr;
+
+    void writeFile(const QString& name, const QByteArray& content) {
+        QString path = QDir(m_workdir).filePath(name);
+        QDir().mkpath(QFileInfo(path).path());
+        QFile file(path);
+        if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            file.write(content);
+        }
+    }
+
+    bool ageFiles(const QStringList& files) {
+        QDateTime past = QDateTime::currentDateTime().addSecs(-3600);
+        for (const QString& name : files) {
+            QFile file(QDir(m_workdir).filePath(name));
+            if (!file.open(QIODevice::ReadWrite) ||
+                !file.setFileTime(past, QFileDevice::FileModificationTime)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool stageAll(unsigned int version) {
+        git_index* index = nullptr;
+        char* pattern = const_cast<char*>("*");
+        git_strarray paths = { &pattern, 1 };
+        bool ok = git_repository_index(&index, m_repo) == 0 &&
+                  git_index_set_version(index, version) == 0 &&
+                  git_index_add_all(index, &paths, GIT_INDEX_ADD_DEFAULT, nullptr, nullptr) == 0 &&
+                  git_index_write(index) == 0;
+        git_index_free(index);
+        return ok;
+    }
+};
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    // User settings (a global autocrlf) would change the expected verdicts
+    QTemporaryDir home;
+    qputenv("HOME", home.path().toLocal8Bit());
+    qputenv("XDG_CONFIG_HOME", home.path().toLocal8Bit());
+
+    git_libgit2_init();
+    IndexReaderTest test;
+    bool ok = test.run();
+    git_libgit2_shutdown();
+    return ok ? 0 : 1;
+}
@@ -5,10 +5,43 @@
 
 #include <QGuiApplication>
 #include <QDir>
+#include <QFile>
 #include <QTemporaryDir>
+#include <QStandardItemModel>
 #include <QDebug>
-#include <QStandardItem>
+#include <functional>
 #include "models/FolderTreeModel.h"
+#include "core/StatEngine.h"
+#include "core/PathFilter.h"
+#include "core/Utf8List.h"
+#include "git/BranchIndex.h"
+
+// glibc reports the heap in use, enough to size a structure built in between
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define TREE_TEST_HEAP
+static qint64 heapInUse()
+{
+    struct mallinfo2 info = mallinfo2();
+    return qint64(info.uordblks) + qint64(info.hblkhd);
+}
+#endif
+
+// Folder item as the tree used to store it, before the flat node array
+class LegacyItem : public QStandardItem {
+public:
+    explicit LegacyItem(const QString& name) : QStandardItem(name) {}
+
+    QString osPath;
+    QString relativePath;
+    int depth = 0;
+    bool isRepo = false;
+    bool needsPull = false;
+    bool needsPush = false;
+    bool needsCommit = false;
+    bool statusError = false;
+    bool statusChecked = false;
+};
 
 class TreeTest {
 public:
@@ -67,24 +100,24 @@ public:
 
         // Test 2: Check root item exists and has children
         qDebug() << "\n--- Test 2: Root item ---";
-        QStandardItem* invisibleRoot = model.invisibleRootItem();
-        if (invisibleRoot->rowCount() != 1) {
-            qCritical() << "FAIL: Expected 1 root item, got" << invisibleRoot->rowCount();
+        if (model.rowCount() != 1) {
+            qCritical() << "FAIL: Expected 1 root item, got" << model.rowCount();
             return false;
         }
 
-        FolderItem* root = dynamic_cast<FolderItem*>(invisibleRoot->child(0));
-        if (!root) {
-            qCritical() << "FAIL: Could not get root FolderItem";
+        QModelIndex root = model.index(0, 0);
+        if (model.nodeAt(root) < 0) {
+            qCritical() << "FAIL: Could not get root node";
             return false;
         }
-        qDebug() << "Root:" << root->text() << "isRepo:" << root->isRepo << "children:" << root->rowCount();
+        qDebug() << "Root:" << root.data().toString() << "isRepo:" << isRepo(model, root)
+                 << "children:" << model.rowCount(root);
         qDebug() << "PASS";
 
         // Test 3: Check root has 3 children (folder1, folder2, repo_at_root)
         qDebug() << "\n--- Test 3: Root children ---";
-        if (root->rowCount() != 3) {
-            qCritical() << "FAIL: Root should have 3 children, got" << root->rowCount();
+        if (model.rowCount(root) != 3) {
+            qCritical() << "FAIL: Root should have 3 children, got" << model.rowCount(root);
             return false;
         }
         qDebug() << "Root has 3 children (expected)";
@@ -92,54 +125,44 @@ public:
 
         // Test 4: Check folder1 has 2 repo children
         qDebug() << "\n--- Test 4: folder1 structure ---";
-        FolderItem* folder1 = nullptr;
-        for (int i = 0; i < root->rowCount(); ++i) {
-            FolderItem* child = dynamic_cast<FolderItem*>(root->child(i));
-            if (child && child->text() == "folder1") {
-                folder1 = child;
-                break;
-            }
-        }
-        if (!folder1) {
+        QModelIndex folder1 = childNamed(model, root, "folder1");
+        if (!folder1.isValid()) {
             qCritical() << "FAIL: Could not find folder1";
             return false;
         }
-        if (folder1->isRepo) {
+        if (isRepo(model, folder1)) {
             qCritical() << "FAIL: folder1 should not be a repo";
             return false;
         }
-        if (folder1->rowCount() != 2) {
-            qCritical() << "FAIL: folder1 should have 2 children, got" << folder1->rowCount();
+        if (model.rowCount(folder1) != 2) {
+            qCritical() << "FAIL: folder1 should have 2 children, got" << model.rowCount(folder1);
             return false;
         }
-        qDebug() << "folder1: isRepo=" << folder1->isRepo << "children=" << folder1->rowCount();
+        if (model.parent(model.index(1, 0, folder1)) != folder1) {
+            qCritical() << "FAIL: folder1 children should point back to folder1";
+            return false;
+        }
+        qDebug() << "folder1: isRepo=" << isRepo(model, folder1) << "children=" << model.rowCount(folder1);
         qDebug() << "PASS";
 
         // Test 5: Check nested structure (folder2/subfolder/repo3)
         qDebug() << "\n--- Test 5: Nested structure ---";
-        FolderItem* folder2 = nullptr;
-        for (int i = 0; i < root->rowCount(); ++i) {
-            FolderItem* child = dynamic_cast<FolderItem*>(root->child(i));
-            if (child && child->text() == "folder2") {
-                folder2 = child;
-                break;
-            }
-        }
-        if (!folder2 || folder2->rowCount() != 1) {
+        QModelIndex folder2 = childNamed(model, root, "folder2");
+        if (!folder2.isValid() || model.rowCount(folder2) != 1) {
             qCritical() << "FAIL: folder2 should have 1 child";
             return false;
         }
-        FolderItem* subfolder = dynamic_cast<FolderItem*>(folder2->child(0));
-        if (!subfolder || subfolder->text() != "subfolder") {
+        QModelIndex subfolder = model.index(0, 0, folder2);
+        if (subfolder.data().toString() != "subfolder") {
             qCritical() << "FAIL: Could not find subfolder";
             return false;
         }
-        if (subfolder->rowCount() != 1) {
-            qCritical() << "FAIL: subfolder should have 1 child, got" << subfolder->rowCount();
+        if (model.rowCount(subfolder) != 1) {
+            qCritical() << "FAIL: subfolder should have 1 child, got" << model.rowCount(subfolder);
             return false;
         }
-        FolderItem* repo3 = dynamic_cast<FolderItem*>(subfolder->child(0));
-        if (!repo3 || !repo3->isRepo) {
+        QModelIndex repo3 = model.index(0, 0, subfolder);
+        if (!isRepo(model, repo3)) {
             qCritical() << "FAIL: repo3 should be a repo";
             return false;
         }
@@ -148,32 +171,497 @@ public:
 
         // Test 6: Check repo_at_root is a repo with no children
         qDebug() << "\n--- Test 6: repo_at_root ---";
-        FolderItem* repoAtRoot = nullptr;
-        for (int i = 0; i < root->rowCount(); ++i) {
-            FolderItem* child = dynamic_cast<FolderItem*>(root->child(i));
-            if (child && child->text() == "repo_at_root") {
-                repoAtRoot = child;
-                break;
-            }
-        }
-        if (!repoAtRoot) {
+        QModelIndex repoAtRoot = childNamed(model, root, "repo_at_root");
+        if (!repoAtRoot.isValid()) {
             qCritical() << "FAIL: Could not find repo_at_root";
             return false;
         }
-        if (!repoAtRoot->isRepo) {
+        if (!isRepo(model, repoAtRoot)) {
             qCritical() << "FAIL: repo_at_root should be a repo";
             return false;
         }
-        if (repoAtRoot->rowCount() != 0) {
+        if (model.rowCount(repoAtRoot) != 0) {
             qCritical() << "FAIL: repo_at_root should have no children";
             return false;
         }
-        qDebug() << "repo_at_root: isRepo=" << repoAtRoot->isRepo << "children=" << repoAtRoot->rowCount();
+        qDebug() << "repo_at_root: isRepo=" << isRepo(model, repoAtRoot)
+                 << "children=" << model.rowCount(repoAtRoot);
+        qDebug() << "PASS";
+
+        // Test 7: Linked worktree with a "gitdir:" file instead of a .git directory
+        qDebug() << "\n--- Test 7: gitdir file ---";
+        {
+            QTemporaryDir wtDir;
+            QDir wtBase(wtDir.path());
+            wtBase.mkpath("main/.git/worktrees/linked");
+            wtBase.mkpath("linked");
+            QFile pointer(wtBase.filePath("linked/.git"));
+            pointer.open(QIODevice::WriteOnly);
+            pointer.write("gitdir: ../main/.git/worktrees/linked\n");
+            pointer.close();
+            QFile commondir(wtBase.filePath("main/.git/worktrees/linked/commondir"));
+            commondir.open(QIODevice::WriteOnly);
+            commondir.write("../..\n");
+            commondir.close();
+
+            FolderTreeModel wtModel;
+            wtModel.scanPaths({wtDir.path()});
+
+            int linked = wtModel.findByPath(wtBase.filePath("linked"));
+            if (linked < 0 || !wtModel.node(linked).isRepo()) {
+                qCritical() << "FAIL: linked worktree should be detected as a repo";
+                return false;
+            }
+            QString expectedGitDir = QDir::cleanPath(wtBase.filePath("main/.git/worktrees/linked"));
+            QString expectedCommonDir = QDir::cleanPath(wtBase.filePath("main/.git"));
+            if (wtModel.gitDir(linked) != expectedGitDir || wtModel.commonDir(linked) != expectedCommonDir) {
+                qCritical() << "FAIL: wrong git dirs" << wtModel.gitDir(linked) << wtModel.commonDir(linked);
+                return false;
+            }
+            qDebug() << "linked: gitDir=" << wtModel.gitDir(linked) << "commonDir=" << wtModel.commonDir(linked);
+        }
+        qDebug() << "PASS";
+
+        // Test 8: Branch index follows added and deleted refs
+        qDebug() << "\n--- Test 8: Branch index ---";
+        {
+            QTemporaryDir refDir;
+            QDir refBase(refDir.path());
+            refBase.mkpath(".git/refs/heads");
+            refBase.mkpath(".git/refs/remotes/origin");
+            auto writeRef = [&](const QString& name) {
+                QFile ref(refBase.filePath(".git/" + name));
+                ref.open(QIODevice::WriteOnly);
+                ref.write("0123456789012345678901234567890123456789\n");
+            };
+            writeRef("refs/heads/main");
+            writeRef("refs/remotes/origin/main");
+            writeRef("refs/remotes/origin/feature");
+
+            BranchIndex index;
+            BranchList first = index.branches(refDir.path());
+            if (first.local != QStringList{"main"} || first.remoteOnly != QStringList{"feature"}) {
+                qCritical() << "FAIL: initial lists" << first.local << first.remoteOnly;
+                return false;
+            }
+
+            // Local "feature" hides the remote one, a new CI branch shows up
+            writeRef("refs/heads/feature");
+            writeRef("refs/remotes/origin/ci-123");
+            BranchList second = index.branches(refDir.path());
+            if (second.local != QStringList({"feature", "main"}) || second.remoteOnly != QStringList{"ci-123"}) {
+                qCritical() << "FAIL: after adding refs" << second.local << second.remoteOnly;
+                return false;
+            }
+
+            // Deleting the local branch brings the remote one back
+            QFile::remove(refBase.filePath(".git/refs/heads/feature"));
+            BranchList third = index.branches(refDir.path());
+            if (third.local != QStringList{"main"} || third.remoteOnly != QStringList({"ci-123", "feature"})) {
+                qCritical() << "FAIL: after deleting a ref" << third.local << third.remoteOnly;
+                return false;
+            }
+        }
+        qDebug() << "PASS";
+
+        // Test 9: Status updates emit dataChanged for the changed repo only
+        qDebug() << "\n--- Test 9: Targeted status updates ---";
+        {
+            QString repoPath = model.nodePath(model.nodeAt(repo3));
+            QList<QModelIndex> changed;
+            QMetaObject::Connection conn = QObject::connect(&model, &QAbstractItemModel::dataChanged,
+                             [&](const QModelIndex& topLeft, const QModelIndex&) { changed.append(topLeft); });
+
+            RepoStatus dirty;
+            dirty.needsCommit = true;
+            model.updateRepoStatus(repoPath, dirty);
+            model.updateRepoStatus(repoPath, dirty);   // unchanged, no signal
+            if (changed.size() != 1 || model.nodePath(model.nodeAt(changed[0])) != repoPath) {
+                qCritical() << "FAIL: expected one dataChanged for" << repoPath << "got" << changed.size();
+                return false;
+            }
+            if (!model.node(model.findByPath(repoPath)).needsCommit()) {
+                qCritical() << "FAIL: needsCommit not stored";
+                return false;
+            }
+            QObject::disconnect(conn);
+        }
+        qDebug() << "PASS";
+
+        // Test 10: Tree footprint on a synthetic shared-drive layout
+        qDebug() << "\n--- Test 10: Tree memory ---";
+        {
+            // 5 departments x 20 teams x 50 projects; project names repeat
+            // across teams as they do on shared drives
+            QTemporaryDir layoutDir;
+            QDir layout(layoutDir.path());
+            for (int dept = 0; dept < 5; ++dept) {
+                for (int team = 0; team < 20; ++team) {
+                    for (int project = 0; project < 50; ++project) {
+                        layout.mkpath(QString("engineering/department-%1/team-%2/service-%3/.git")
+                                          .arg(dept).arg(team).arg(project, 3, 10, QLatin1Char('0')));
+                    }
+                }
+            }
+
+            FolderTreeModel layoutModel;
+            layoutModel.scanPaths({layoutDir.path()});
+            int repos = layoutModel.getAllRepoPaths().size();
+            qint64 modelBytes = layoutModel.memoryUsage();
+
+            // Previous representation of the same tree: a QStandardItem per
+            // folder carrying its full and relative path, indexed by path
+            qint64 legacyBytes = -1;
+#ifdef TREE_TEST_HEAP
+            qint64 heapBefore = heapInUse();
+            {
+                QStandardItemModel legacy;
+                QHash<QString, QStandardItem*> byPath;
+                std::function<void(const QModelIndex&, QStandardItem*)> copy =
+                    [&](const QModelIndex& parent, QStandardItem* into) {
+                        for (int row = 0; row < layoutModel.rowCount(parent); ++row) {
+                            QModelIndex index = layoutModel.index(row, 0, parent);
+                            int node = layoutModel.nodeAt(index);
+                            auto* item = new LegacyItem(layoutModel.nodeName(node));
+                            item->osPath = layoutModel.nodePath(node);
+                            item->relativePath = layout.relativeFilePath(item->osPath);
+                            item->depth = layoutModel.node(node).depth;
+                            item->isRepo = layoutModel.node(node).isRepo();
+                            into->appendRow(item);
+                            byPath.insert(item->osPath, item);
+                            copy(index, item);
+                        }
+                    };
+                copy(QModelIndex(), legacy.invisibleRootItem());
+                legacyBytes = heapInUse() - heapBefore;
+            }
+#endif
+
+            qDebug() << "Repositories:" << repos << "model:" << modelBytes / 1024 << "KiB";
+            if (repos != 5000) {
+                qCritical() << "FAIL: expected 5000 repositories, got" << repos;
+                return false;
+            }
+            if (legacyBytes < 0) {
+                qDebug() << "Heap statistics unavailable, comparison skipped";
+            } else {
+                qDebug() << "Item tree:" << legacyBytes / 1024 << "KiB, saving:"
+                         << 100 - modelBytes * 100 / legacyBytes << "%";
+                if (modelBytes >= legacyBytes) {
+                    qCritical() << "FAIL: flat tree should be smaller than the item tree";
+                    return false;
+                }
+            }
+
+            // Paths rebuilt from parent chains round-trip exactly
+            QString sample = layout.filePath("engineering/department-3/team-17/service-042");
+            int id = layoutModel.findByPath(sample);
+            if (id < 0 || layoutModel.nodePath(id) != sample ||
+                layoutModel.findByPath(layout.filePath("engineering/department-3/team-17/service-050")) >= 0) {
+                qCritical() << "FAIL: path lookup or reconstruction broken";
+                return false;
+            }
+        }
+        qDebug() << "PASS";
+
+        // Test 11: Bulk status apply merges sibling rows and skips unchanged repos
+        qDebug() << "\n--- Test 11: Bulk status updates ---";
+        {
+            QList<QPair<int, int>> ranges;
+            QMetaObject::Connection conn = QObject::connect(&model, &QAbstractItemModel::dataChanged,
+                             [&](const QModelIndex& topLeft, const QModelIndex& bottomRight) {
+                                 ranges.append({topLeft.row(), bottomRight.row()});
+                             });
+
+            // repo1 and repo2 are adjacent rows, repo3 already needs a commit
+            RepoStatus dirty;
+            dirty.needsCommit = true;
+            QHash<QString, RepoStatus> statuses;
+            for (int i = 0; i < model.rowCount(folder1); ++i) {
+                statuses.insert(model.nodePath(model.nodeAt(model.index(i, 0, folder1))), dirty);
+            }
+            statuses.insert(model.nodePath(model.nodeAt(repo3)), dirty);
+
+            int changed = model.updateRepoStatuses(statuses);
+            if (changed != 2 || ranges.size() != 1 || ranges[0] != qMakePair(0, 1)) {
+                qCritical() << "FAIL: expected 2 changes in one range, got" << changed << ranges;
+                return false;
+            }
+            if (model.updateRepoStatuses(statuses) != 0 || ranges.size() != 1) {
+                qCritical() << "FAIL: unchanged statuses should not emit dataChanged";
+                return false;
+            }
+            QObject::disconnect(conn);
+        }
+        qDebug() << "PASS";
+
+        // Test 12: Incremental rescan inserts and removes rows in place
+        qDebug() << "\n--- Test 12: Incremental rescan ---";
+        {
+            int folder1Node = model.nodeAt(folder1);
+            QString repo1Path = base.filePath("folder1/repo1");
+            int inserted = 0, removed = 0, resets = 0;
+            QMetaObject::Connection c1 = QObject::connect(&model, &QAbstractItemModel::rowsInserted,
+                [&](const QModelIndex&, int first, int last) { inserted += last - first + 1; });
+            QMetaObject::Connection c2 = QObject::connect(&model, &QAbstractItemModel::rowsRemoved,
+                [&](const QModelIndex&, int first, int last) { removed += last - first + 1; });
+            QMetaObject::Connection c3 = QObject::connect(&model, &QAbstractItemModel::modelReset,
+                [&]() { resets++; });
+
+            // Nothing changed on disk: no row operations
+            model.rescan({basePath});
+            if (inserted != 0 || removed != 0) {
+                qCritical() << "FAIL: unchanged tree produced row changes" << inserted << removed;
+                return false;
+            }
+
+            // A clone next to repo1, and repo_at_root deleted
+            base.mkpath("folder1/repo0/.git");
+            QDir(base.filePath("repo_at_root")).removeRecursively();
+            model.rescan({basePath});
+
+            QModelIndex newFolder1 = model.indexOf(folder1Node);
+            if (inserted != 1 || removed != 1 || resets != 0) {
+                qCritical() << "FAIL: expected 1 insert and 1 removal, got" << inserted << removed << resets;
+                return false;
+            }
+            if (model.rowCount(newFolder1) != 3 || model.index(0, 0, newFolder1).data().toString() != "repo0") {
+                qCritical() << "FAIL: repo0 should be the first child of folder1";
+                return false;
+            }
+            if (model.findByPath(base.filePath("repo_at_root")) >= 0 ||
+                childNamed(model, model.index(0, 0), "repo_at_root").isValid()) {
+                qCritical() << "FAIL: repo_at_root should be gone";
+                return false;
+            }
+            if (!model.node(model.findByPath(repo1Path)).needsCommit()) {
+                qCritical() << "FAIL: status of untouched repos should survive a rescan";
+                return false;
+            }
+
+            // Rows removed and added again reuse the slots they left behind
+            qint64 settledBytes = 0;
+            for (int cycle = 0; cycle < 50; ++cycle) {
+                QDir(base.filePath("folder1/repo0")).removeRecursively();
+                model.rescan({basePath});
+                base.mkpath("folder1/repo0/.git");
+                model.rescan({basePath});
+                if (cycle == 0) {
+                    settledBytes = model.memoryUsage();
+                }
+            }
+            if (model.memoryUsage() > settledBytes || model.rowCount(model.indexOf(folder1Node)) != 3) {
+                qCritical() << "FAIL: repeated rescans should not grow the tree"
+                            << settledBytes << model.memoryUsage();
+                return false;
+            }
+            QObject::disconnect(c1);
+            QObject::disconnect(c2);
+            QObject::disconnect(c3);
+        }
+        qDebug() << "PASS";
+
+        // Test 13: Discovery depth, exclusion globs, nested repos and symlink loops
+        qDebug() << "\n--- Test 13: Discovery options ---";
+        {
+            QTemporaryDir discoDir;
+            QDir disco(discoDir.path());
+            disco.mkpath("shallow/.git");
+            disco.mkpath("shallow/inner/.git");
+            disco.mkpath("x/y/z/deep/.git");
+            disco.mkpath("junk.cache/r/.git");
+            QFile::link(discoDir.path(), disco.filePath("x/loop"));
+
+            DiscoveryOptions options;
+            options.maxDepth = 3;
+            options.exclude = {".*", "*.cache"};
+            FolderTreeModel discoModel;
+            discoModel.setDiscoveryOptions(options);
+            discoModel.scanPaths({discoDir.path()});
+            QStringList found = discoModel.getAllRepoPaths();
+            if (found != QStringList{disco.filePath("shallow")}) {
+                qCritical() << "FAIL: depth 3 with *.cache excluded found" << found;
+                return false;
+            }
+
+            // Unlimited depth, looking inside repositories
+            options.maxDepth = 0;
+            options.stopAtRepos = false;
+            discoModel.setDiscoveryOptions(options);
+            discoModel.rescan({discoDir.path()});
+            found = discoModel.getAllRepoPaths();
+            int inner = discoModel.findByPath(disco.filePath("shallow/inner"));
+            if (found.size() != 3 || inner < 0 ||
+                discoModel.nodePath(discoModel.node(inner).parent) != disco.filePath("shallow")) {
+                qCritical() << "FAIL: expected shallow, shallow/inner and deep, found" << found;
+                return false;
+            }
+            qDebug() << "Found:" << found;
+        }
+        qDebug() << "PASS";
+
+        // Test 14: Submodules are child rows and roll up into their repository
+        qDebug() << "\n--- Test 14: Submodule aggregation ---";
+        {
+            QTemporaryDir superDir;
+            QDir superBase(superDir.path());
+            superBase.mkpath("super/.git");
+            superBase.mkpath("super/libs/core/.git");
+            QFile gitmodules(superBase.filePath("super/.gitmodules"));
+            gitmodules.open(QIODevice::WriteOnly);
+            gitmodules.write("[submodule \"core\"]\n\tpath = libs/core\n\turl = ../core.git\n");
+            gitmodules.close();
+
+            DiscoveryOptions options;
+            options.submodules = true;
+            FolderTreeModel superModel;
+            superModel.setDiscoveryOptions(options);
+            superModel.scanPaths({superDir.path()});
+
+            int super = superModel.findByPath(superBase.filePath("super"));
+            int core = superModel.findByPath(superBase.filePath("super/libs/core"));
+            if (super < 0 || core < 0 || superModel.node(core).parent != super) {
+                qCritical() << "FAIL: submodule should be a child row of its repository";
+                return false;
+            }
+
+            int changed = 0;
+            QObject::connect(&superModel, &QAbstractItemModel::dataChanged,
+                             [&](const QModelIndex&, const QModelIndex&) { changed++; });
+            RepoStatus dirty;
+            dirty.needsCommit = true;
+            superModel.updateRepoStatus(superBase.filePath("super/libs/core"), dirty);
+
+            const FolderNode& superNode = superModel.node(super);
+            if (changed != 2 || superNode.needsCommit() ||
+                !(superNode.childFlags & FolderNode::NeedsCommit)) {
+                qCritical() << "FAIL: submodule state should roll up into its parent row" << changed;
+                return false;
+            }
+        }
+        qDebug() << "PASS";
+
+        // Test 15: Batched stats agree with statPath and feed the walk
+        qDebug() << "\n--- Test 15: Batched stat engine ---";
+        {
+            QTemporaryDir statDir;
+            QDir statBase(statDir.path());
+            QStringList paths;
+            for (int i = 0; i < 100; ++i) {
+                statBase.mkpath(QString("repo%1/.git").arg(i));
+                paths.append(statBase.filePath(QString("repo%1").arg(i)));
+            }
+            paths.append(statBase.filePath("missing"));
+
+            QVector<QByteArray> encoded;
+            QVector<const char*> names;
+            for (const QString& path : paths) {
+                encoded.append(QFile::encodeName(path));
+            }
+            for (const QByteArray& name : encoded) {
+                names.append(name.constData());
+            }
+
+            for (StatEngine::Backend backend : {StatEngine::Serial, StatEngine::ThreadPool}) {
+                StatEngine engine(backend);
+                QVector<StatResult> results(names.size());
+                engine.stat(StatEngine::CurrentDir, names.constData(), names.size(), results.data());
+                for (int i = 0; i < paths.size(); ++i) {
+                    FileStamp stamp;
+                    FileId id;
+                    bool exists = statPath(paths[i], &stamp, &id);
+                    if (exists != (results[i].error == 0) ||
+                        (exists && (results[i].stamp() != stamp || !(results[i].id() == id) ||
+                                    !results[i].isDir()))) {
+                        qCritical() << "FAIL:" << StatEngine::backendName(backend)
+                                    << "disagrees with statPath on" << paths[i];
+                        return false;
+                    }
+                }
+            }
+
+            FolderTreeModel statModel;
+            statModel.scanPaths({statDir.path()});
+            if (statModel.getAllRepoPaths().size() != 100) {
+                qCritical() << "FAIL: Expected 100 repositories from a batched walk, got"
+                            << statModel.getAllRepoPaths().size();
+                return false;
+            }
+        }
+        qDebug() << "PASS";
+
+        // Test 16: Raw UTF-8 path filter agrees with QString matching
+        qDebug() << "\n--- Test 16: Path filter kernels ---";
+        {
+            PathFilter filter({".idea/", "venv/", "a/very/long/prefix/over/16/"},
+                              {"/__pycache__/", "~"});
+            qDebug() << "Kernel:" << PathFilter::kernelName();
+
+            // Lengths around the 16 and 32 byte steps, matches at every offset
+            QStringList samples = {"", ".idea", ".idea/", "venv/bin/python", "src/venv/x",
+                                   "a/very/long/prefix/over/16/file", "a/very/long/prefix/over/1",
+                                   "src/__pycache__/mod.pyc", "__pycache__/top.pyc", "héllo/wörld~"};
+            for (int length = 0; length < 80; ++length) {
+                QString filler(length, QLatin1Char('p'));
+                samples << filler << filler + "/__pycache__/" << "/__pycache__" + filler
+                        << filler.left(length / 2) + "~" + filler.mid(length / 2);
+            }
+
+            for (const QString& path : samples) {
+                bool expected = path.startsWith(".idea/") || path.startsWith("venv/") ||
+                                path.startsWith("a/very/long/prefix/over/16/") ||
+                                path.contains("/__pycache__/") || path.contains("~");
+                QByteArray utf8 = path.toUtf8();
+                if (filter.matches(utf8.constData(), utf8.size()) != expected) {
+                    qCritical() << "FAIL: filter disagrees on" << path << "expected" << expected;
+                    return false;
+                }
+            }
+        }
+        qDebug() << "PASS";
+
+        // Test 17: UTF-8 path lists keep bytes, order and decoding
+        qDebug() << "\n--- Test 17: UTF-8 path lists ---";
+        {
+            QStringList names = {"src/Zeta.cpp", "README", "docs/ünïcode.md", "src/alpha.cpp", "b"};
+            Utf8List list = Utf8List::fromStringList(names);
+            Utf8List shared = list;
+            list.sortCaseInsensitive();
+
+            QStringList expected = {"b", "docs/ünïcode.md", "README", "src/alpha.cpp", "src/Zeta.cpp"};
+            if (list.toStringList() != expected || shared.toStringList() != names) {
+                qCritical() << "FAIL: Unexpected order" << list.toStringList() << shared.toStringList();
+                return false;
+            }
+            for (int i = 0; i < list.size(); ++i) {
+                QByteArray utf8 = expected[i].toUtf8();
+                if (list.view(i).toByteArray() != utf8 || qstrlen(list.data(i)) != uint(utf8.size())) {
+                    qCritical() << "FAIL: Item" << i << "is not its NUL-terminated UTF-8";
+                    return false;
+                }
+            }
+        }
         qDebug() << "PASS";
 
         qDebug() << "\n=== ALL TESTS PASSED ===";
         return true;
     }
+
+private:
+    static bool isRepo(const FolderTreeModel& model, const QModelIndex& index) {
+        int node = model.nodeAt(index);
+        return node >= 0 && model.node(node).isRepo();
+    }
+
+    static QModelIndex childNamed(const FolderTreeModel& model, const QModelIndex& parent, const QString& name) {
+        for (int i = 0; i < model.rowCount(parent); ++i) {
+            QModelIndex child = model.index(i, 0, parent);
+            if (child.data().toString() == name) {
+                return child;
+            }
+        }
+        return QModelIndex();
+    }
 };
 
 int main(int argc, char *argv[]) {